@@ -0,0 +1,43 @@
+#pragma once
+#include "utility/types.h"
+
+#include <chrono>
+#include <cstdio>
+
+namespace benchmark {
+	using namespace utility::types;
+
+	/**
+	 * \brief Invokes \b func once and returns the elapsed wall-clock time in nanoseconds.
+	 */
+	template<typename function>
+	[[nodiscard]] auto measure(function&& func) -> f64 {
+		const auto start = std::chrono::steady_clock::now();
+		func();
+		return std::chrono::duration<f64, std::nano>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	/**
+	 * \brief Invokes \b func \b runs times and returns the fastest run in nanoseconds, which filters out
+	 * one-off costs like page faults on freshly mapped memory.
+	 */
+	template<typename function>
+	[[nodiscard]] auto measure_best(u64 runs, function&& func) -> f64 {
+		f64 best = measure(func);
+
+		for(u64 i = 1; i < runs; ++i) {
+			const f64 time = measure(func);
+			best = time < best ? time : best;
+		}
+
+		return best;
+	}
+
+	/**
+	 * \brief Keeps the optimizer from discarding the computation of \b value.
+	 */
+	inline void consume(u64 value) {
+		static volatile u64 sink;
+		sink = sink + value;
+	}
+} // namespace benchmark
@@ -0,0 +1,132 @@
+#include "benchmarks/benchmark.h"
+#include "utility/containers/btree_map.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace utility::types;
+
+namespace {
+	using element = std::pair<u64, u64>;
+
+	// btree_map against std::sort + std::lower_bound on a sorted array, half of the lookups hit
+	void run(u64 count) {
+		constexpr u64 query_count = 4'000'000;
+		constexpr u64 scan_count = 1000;
+		constexpr u64 scan_length = 1000;
+
+		std::mt19937_64 rng(count);
+		std::vector<element> input(count);
+		std::vector<u64> queries(query_count);
+
+		for(u64 i = 0; i < count; ++i) {
+			input[i] = { rng(), i };
+		}
+
+		for(u64& query : queries) {
+			query = rng() % 2 ? input[rng() % count].first : rng();
+		}
+
+		std::vector<element> array;
+		utility::btree_map<u64, u64> tree;
+
+		const f64 sort_time = benchmark::measure([&] {
+			array = input;
+			std::sort(array.begin(), array.end());
+		});
+
+		const f64 insert_time = benchmark::measure([&] {
+			utility::btree_map<u64, u64> inserted;
+
+			for(const element& e : input) {
+				inserted.insert(e);
+			}
+
+			benchmark::consume(inserted.get_size());
+		});
+
+		const f64 bulk_time = benchmark::measure([&] {
+			std::vector<element> sorted = input;
+			std::sort(sorted.begin(), sorted.end());
+			tree.assign_sorted(sorted.begin(), sorted.end());
+		});
+
+		const f64 array_lookup_time = benchmark::measure([&] {
+			u64 sum = 0;
+
+			for(const u64 query : queries) {
+				const auto it = std::lower_bound(array.begin(), array.end(), element{ query, 0 });
+				sum += it != array.end() ? it->second : 0;
+			}
+
+			benchmark::consume(sum);
+		});
+
+		const f64 tree_lookup_time = benchmark::measure([&] {
+			u64 sum = 0;
+
+			for(const u64 query : queries) {
+				const auto it = tree.lower_bound(query);
+				sum += it != tree.end() ? it->second : 0;
+			}
+
+			benchmark::consume(sum);
+		});
+
+		const f64 array_scan_time = benchmark::measure([&] {
+			u64 sum = 0;
+
+			for(u64 i = 0; i < scan_count; ++i) {
+				auto it = std::lower_bound(array.begin(), array.end(), element{ queries[i], 0 });
+
+				for(u64 j = 0; j < scan_length && it != array.end(); ++j, ++it) {
+					sum += it->second;
+				}
+			}
+
+			benchmark::consume(sum);
+		});
+
+		const f64 tree_scan_time = benchmark::measure([&] {
+			u64 sum = 0;
+
+			for(u64 i = 0; i < scan_count; ++i) {
+				auto it = tree.lower_bound(queries[i]);
+
+				for(u64 j = 0; j < scan_length && it != tree.end(); ++j, ++it) {
+					sum += it->second;
+				}
+			}
+
+			benchmark::consume(sum);
+		});
+
+		const f64 n = static_cast<f64>(count);
+		const f64 q = static_cast<f64>(query_count);
+		const f64 s = static_cast<f64>(scan_count * scan_length);
+
+		std::printf(
+			"%8llu  %6.1f  %6.1f  %6.1f  %6.1f   %6.1f    %6.1f     %6.1f\n",
+			static_cast<unsigned long long>(count),
+			sort_time / n,
+			bulk_time / n,
+			insert_time / n,
+			array_lookup_time / q,
+			tree_lookup_time / q,
+			array_scan_time / s,
+			tree_scan_time / s
+		);
+	}
+} // namespace
+
+auto main() -> int {
+	std::printf("ns per element or lookup, bulk = sort + assign_sorted, lb = lower_bound\n");
+	std::printf("       n    sort    bulk  insert  lb arr  lb tree  scan arr  scan tree\n");
+
+	for(const u64 count : { 1'000, 100'000, 4'000'000 }) {
+		run(count);
+	}
+
+	return 0;
+}
@@ -0,0 +1,56 @@
+#include "benchmarks/benchmark.h"
+#include "utility/allocators/concurrent_block_allocator.h"
+
+#include <thread>
+#include <vector>
+
+using namespace utility::types;
+
+namespace {
+	// every thread performs the same number of allocations, either directly from the shared arena or
+	// through its own cache
+	void run(u64 thread_count, bool use_cache) {
+		constexpr u64 allocations_per_thread = 2'000'000;
+		utility::concurrent_block_allocator allocator(1 << 20);
+
+		const f64 time = benchmark::measure([&] {
+			std::vector<std::thread> threads;
+
+			for(u64 t = 0; t < thread_count; ++t) {
+				threads.emplace_back([&] {
+					auto cache = allocator.create_cache(16384);
+					u64 sum = 0;
+
+					for(u64 i = 0; i < allocations_per_thread; ++i) {
+						sum += *(use_cache ? cache.emplace<u64>(i) : allocator.emplace<u64>(i));
+					}
+
+					benchmark::consume(sum);
+				});
+			}
+
+			for(std::thread& thread : threads) {
+				thread.join();
+			}
+		});
+
+		std::printf(
+			"%s %2llu threads: %6.1f M allocations/s\n",
+			use_cache ? "cache " : "shared", static_cast<unsigned long long>(thread_count),
+			static_cast<f64>(thread_count * allocations_per_thread) / time * 1e3
+		);
+	}
+} // namespace
+
+auto main() -> int {
+	const u64 max_threads = std::thread::hardware_concurrency();
+	std::printf("hardware threads: %llu\n", static_cast<unsigned long long>(max_threads));
+
+	for(const bool use_cache : { false, true }) {
+		for(u64 thread_count = 1; thread_count <= 8; thread_count *= 2) {
+			run(thread_count, use_cache);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,110 @@
+#include "benchmarks/benchmark.h"
+#include "utility/containers/concurrent_map.h"
+
+#include <random>
+#include <vector>
+
+using namespace utility::types;
+
+namespace {
+	// the baseline, a single map behind a single lock
+	struct locked_map {
+		auto contains(u64 k) -> bool {
+			std::lock_guard lock(mutex);
+			return data.contains(k);
+		}
+		void insert(u64 k) {
+			std::lock_guard lock(mutex);
+			data.try_emplace(k, k);
+		}
+		void erase(u64 k) {
+			std::lock_guard lock(mutex);
+			data.erase(k);
+		}
+
+		std::mutex mutex;
+		utility::map<u64, u64> data;
+	};
+
+	struct sharded_map {
+		auto contains(u64 k) -> bool {
+			return data.contains(k);
+		}
+		void insert(u64 k) {
+			data.insert(k, k);
+		}
+		void erase(u64 k) {
+			data.erase(k);
+		}
+
+		utility::concurrent_map<u64, u64> data;
+	};
+
+	constexpr u64 key_count = 200'000;
+	constexpr u64 operation_count = 2'000'000;
+
+	// splits a fixed number of random operations between the threads, half of the writes are inserts and
+	// half are erases, returns millions of operations per second
+	template<typename map_type>
+	[[nodiscard]] auto run(u64 thread_count, u64 write_percentage) -> f64 {
+		map_type map;
+
+		for(u64 k = 0; k < key_count; k += 2) {
+			map.insert(k);
+		}
+
+		const f64 time = benchmark::measure([&] {
+			std::vector<std::thread> threads;
+
+			for(u64 t = 0; t < thread_count; ++t) {
+				threads.emplace_back([&, t] {
+					std::mt19937_64 rng(t);
+					u64 hits = 0;
+
+					for(u64 i = 0; i < operation_count / thread_count; ++i) {
+						const u64 k = rng() % key_count;
+						const u64 operation = rng() % 100;
+
+						if(operation < write_percentage / 2) {
+							map.insert(k);
+						}
+						else if(operation < write_percentage) {
+							map.erase(k);
+						}
+						else {
+							hits += map.contains(k);
+						}
+					}
+
+					benchmark::consume(hits);
+				});
+			}
+
+			for(std::thread& thread : threads) {
+				thread.join();
+			}
+		});
+
+		return static_cast<f64>(operation_count) / time * 1e3;
+	}
+} // namespace
+
+// scaling depends on the core count, on a single core this only shows the cost of the extra hash and
+// the reader-writer locks
+auto main() -> int {
+	std::printf("%u hardware threads\n", std::thread::hardware_concurrency());
+
+	for(const u64 writes : { 5, 50 }) {
+		for(const u64 threads : { 1, 2, 4, 8 }) {
+			std::printf(
+				"writes %2llu%%, %llu threads: mutex map %.1f Mops/s, concurrent_map %.1f Mops/s\n",
+				static_cast<unsigned long long>(writes),
+				static_cast<unsigned long long>(threads),
+				run<locked_map>(threads, writes),
+				run<sharded_map>(threads, writes)
+			);
+		}
+	}
+
+	return 0;
+}
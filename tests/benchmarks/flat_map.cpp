@@ -0,0 +1,124 @@
+#include "benchmarks/benchmark.h"
+#include "utility/containers/flat_map.h"
+
+#include <random>
+
+using namespace utility::types;
+
+namespace {
+	struct timings {
+		f64 insert;
+		f64 hit;
+		f64 miss;
+	};
+
+	// per-operation times in nanoseconds, lookups are repeated to get above the timer resolution
+	template<typename map_type>
+	[[nodiscard]] auto run(map_type& map, const utility::dynamic_array<u64>& keys, const utility::dynamic_array<u64>& misses) -> timings {
+		constexpr u64 rounds = 4;
+		const f64 count = static_cast<f64>(keys.get_size());
+
+		const f64 insert = benchmark::measure([&] {
+			for(const u64 k : keys) {
+				map[k] = k;
+			}
+		});
+
+		const f64 hit = benchmark::measure([&] {
+			u64 sum = 0;
+
+			for(u64 r = 0; r < rounds; ++r) {
+				for(const u64 k : keys) {
+					sum += map.find(k)->second;
+				}
+			}
+
+			benchmark::consume(sum);
+		});
+
+		const f64 miss = benchmark::measure([&] {
+			u64 found = 0;
+
+			for(u64 r = 0; r < rounds; ++r) {
+				for(const u64 k : misses) {
+					found += map.contains(k);
+				}
+			}
+
+			benchmark::consume(found);
+		});
+
+		return { insert / count, hit / rounds / count, miss / rounds / count };
+	}
+
+	// flat_map against map at the same element count, the flat map is sized so that it doesn't rehash
+	void load_factors() {
+		constexpr u64 slot_count = 1 << 21;
+		std::mt19937_64 rng(7);
+
+		std::printf("load  flat_map ins/hit/miss    map ins/hit/miss (ns)\n");
+
+		for(const f64 load : { 0.5, 0.6, 0.7, 0.8, 0.9 }) {
+			const u64 count = static_cast<u64>(slot_count * load) - 16;
+			utility::dynamic_array<u64> keys;
+			utility::dynamic_array<u64> misses;
+
+			for(u64 i = 0; i < count; ++i) {
+				keys.push_back(rng());
+				misses.push_back(rng());
+			}
+
+			utility::flat_map<u64, u64> flat;
+			flat.set_max_load_factor(0.95f);
+			flat.reserve(static_cast<u64>(slot_count * 0.95));
+
+			utility::map<u64, u64> map;
+
+			const timings f = run(flat, keys, misses);
+			const timings m = run(map, keys, misses);
+
+			std::printf("%.1f   %5.1f / %5.1f / %5.1f     %5.1f / %5.1f / %5.1f\n", load, f.insert, f.hit, f.miss, m.insert, m.hit, m.miss);
+		}
+	}
+
+	// erases the oldest element and inserts a new one, which keeps the live size constant while the
+	// table fills up with tombstones
+	void churn() {
+		constexpr u64 operations = 2'000'000;
+
+		for(const u64 capacity : { 1024, 16384, 262144 }) {
+			for(const f64 load : { 0.5, 0.87 }) {
+				utility::flat_map<u64, u64> map;
+				map.reserve(static_cast<u64>(capacity * 0.87));
+
+				const u64 count = static_cast<u64>(capacity * load) - 1;
+				u64 next = count;
+
+				for(u64 i = 0; i < count; ++i) {
+					map.insert({ i, i });
+				}
+
+				const f64 time = benchmark::measure([&] {
+					for(u64 i = 0; i < operations; ++i, ++next) {
+						map.erase(next - count);
+						map.insert({ next, next });
+					}
+				});
+
+				std::printf(
+					"churn, capacity %llu, load %.2f: %.1f ns per erase + insert\n",
+					static_cast<unsigned long long>(capacity),
+					load,
+					time / operations
+				);
+			}
+		}
+	}
+} // namespace
+
+auto main() -> int {
+	load_factors();
+	churn();
+
+	return 0;
+}
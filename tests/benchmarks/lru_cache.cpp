@@ -0,0 +1,65 @@
+#include "benchmarks/benchmark.h"
+#include "utility/containers/lru_cache.h"
+
+#include <random>
+
+using namespace utility::types;
+
+namespace {
+	// a get-or-put loop over \b keys, the cache holds 10k entries
+	template<utility::cache_policy policy>
+	void run(const char* name, const utility::dynamic_array<u64>& keys) {
+		utility::lru_cache<u64, u64, policy> cache(10'000);
+
+		const f64 time = benchmark::measure([&] {
+			u64 sum = 0;
+
+			for(const u64 k : keys) {
+				if(const u64* v = cache.get(k)) {
+					sum += *v;
+				}
+				else {
+					cache.put(k, k);
+				}
+			}
+
+			benchmark::consume(sum);
+		});
+
+		const utility::cache_statistics& statistics = cache.get_statistics();
+
+		std::printf(
+			"  %s %.1f ns per operation, hit rate %.3f\n",
+			name,
+			time / static_cast<f64>(keys.get_size()),
+			static_cast<f64>(statistics.hits) / static_cast<f64>(statistics.hits + statistics.misses)
+		);
+	}
+
+	void run_all(const char* name, const utility::dynamic_array<u64>& keys) {
+		std::printf("%s:\n", name);
+		run<utility::cache_policy::lru>("lru  ", keys);
+		run<utility::cache_policy::clock>("clock", keys);
+	}
+} // namespace
+
+auto main() -> int {
+	constexpr u64 operation_count = 10'000'000;
+
+	std::mt19937_64 rng(1);
+	std::uniform_real_distribution<f64> distribution(0.0, 1.0);
+	utility::dynamic_array<u64> skewed;
+	utility::dynamic_array<u64> hot;
+
+	// cubing a uniform sample skews the keys towards zero
+	for(u64 i = 0; i < operation_count; ++i) {
+		const f64 u = distribution(rng);
+		skewed.push_back(static_cast<u64>(100'000 * u * u * u));
+		hot.push_back(skewed[i] % 10'000);
+	}
+
+	run_all("skewed keys over 100k", skewed);
+	run_all("working set fits", hot);
+
+	return 0;
+}
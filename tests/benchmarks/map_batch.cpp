@@ -0,0 +1,60 @@
+#include "benchmarks/benchmark.h"
+#include "utility/containers/map.h"
+
+#include <cstdlib>
+#include <random>
+
+using namespace utility::types;
+
+// the table has to be much larger than the last level cache for the prefetches to matter, the element
+// count can be passed as the first argument
+auto main(int argc, char** argv) -> int {
+	const u64 count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 32'000'000;
+	constexpr u64 query_count = 10'000'000;
+
+	utility::map<u64, u64> map(count);
+	utility::dynamic_array<u64> keys;
+	std::mt19937_64 rng(7);
+
+	keys.reserve(count);
+
+	for(u64 i = 0; i < count; ++i) {
+		keys.push_back(rng());
+		map[keys[i]] = i;
+	}
+
+	// every other query hits
+	utility::dynamic_array<u64> queries;
+	queries.reserve(query_count);
+
+	for(u64 i = 0; i < query_count; ++i) {
+		queries.push_back(i & 1 ? keys[rng() % count] : rng());
+	}
+
+	utility::dynamic_array<bool> results(query_count, false);
+
+	const f64 loop_time = benchmark::measure([&] {
+		u64 hits = 0;
+
+		for(const u64 query : queries) {
+			hits += map.contains(query);
+		}
+
+		benchmark::consume(hits);
+	});
+
+	const f64 batch_time = benchmark::measure([&] {
+		map.contains_batch(queries.get_data(), query_count, results.get_data());
+		benchmark::consume(results[query_count - 1]);
+	});
+
+	std::printf(
+		"%llu elements (%.0f MB), 10M lookups: contains() %.1f M/s, contains_batch() %.1f M/s\n",
+		static_cast<unsigned long long>(count),
+		static_cast<f64>(map.get_memory_usage()) / 1e6,
+		static_cast<f64>(query_count) / loop_time * 1e3,
+		static_cast<f64>(query_count) / batch_time * 1e3
+	);
+
+	return 0;
+}
@@ -0,0 +1,49 @@
+#include "benchmarks/benchmark.h"
+#include "utility/allocators/pool_allocator.h"
+
+#include <vector>
+
+using namespace utility::types;
+
+namespace {
+	template<u64 size>
+	struct object {
+		u8 data[size];
+	};
+
+	template<u64 size>
+	void run() {
+		constexpr u64 count = 1'000'000;
+		constexpr u64 rounds = 5;
+
+		std::vector<void*> pointers(count);
+
+		const f64 malloc_time = benchmark::measure([&] {
+			for(u64 r = 0; r < rounds; ++r) {
+				for(void*& p : pointers) { p = utility::malloc(size); }
+				for(void* p : pointers) { utility::free(p); }
+			}
+		});
+
+		utility::pool_allocator<object<size>> pool(4096);
+
+		const f64 pool_time = benchmark::measure([&] {
+			for(u64 r = 0; r < rounds; ++r) {
+				for(void*& p : pointers) { p = pool.allocate(); }
+				for(void* p : pointers) { pool.deallocate(static_cast<object<size>*>(p)); }
+			}
+		});
+
+		std::printf(
+			"%4llu B objects: malloc/free %.1f ns, pool %.1f ns per allocation\n",
+			static_cast<unsigned long long>(size), malloc_time / (count * rounds), pool_time / (count * rounds)
+		);
+	}
+} // namespace
+
+auto main() -> int {
+	run<16>();
+	run<64>();
+	run<256>();
+	return 0;
+}
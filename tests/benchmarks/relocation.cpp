@@ -0,0 +1,28 @@
+#include "benchmarks/benchmark.h"
+#include "utility/containers/dynamic_array.h"
+#include "utility/containers/dynamic_string.h"
+
+using namespace utility::types;
+
+// growing an array of strings relocates every string on each reallocation
+auto main() -> int {
+	constexpr u64 rounds = 200;
+	constexpr u64 count = 10'000;
+
+	const f64 time = benchmark::measure([&] {
+		for(u64 r = 0; r < rounds; ++r) {
+			utility::dynamic_array<utility::dynamic_string> strings;
+
+			for(u64 i = 0; i < count; ++i) {
+				strings.push_back(utility::dynamic_string("a path/like/string/of/moderate/length.txt"));
+			}
+
+			benchmark::consume(strings.get_size());
+		}
+	});
+
+	std::printf("%llu rounds of growing a dynamic_array<dynamic_string> to %llu elements: %.1f ms\n",
+		static_cast<unsigned long long>(rounds), static_cast<unsigned long long>(count), time / 1e6);
+
+	return 0;
+}
@@ -0,0 +1,47 @@
+#include "benchmarks/benchmark.h"
+#include "utility/containers/dynamic_string.h"
+#include "utility/containers/segmented_array.h"
+
+using namespace utility::types;
+
+namespace {
+	// the elements are produced by \b make_value(index)
+	template<typename array_type, typename function>
+	[[nodiscard]] auto run(u64 count, function&& make_value) -> f64 {
+		constexpr u64 rounds = 50;
+
+		return benchmark::measure_best(5, [&] {
+			for(u64 r = 0; r < rounds; ++r) {
+				array_type array;
+
+				for(u64 i = 0; i < count; ++i) {
+					array.push_back(make_value(i));
+				}
+
+				benchmark::consume(array.get_size());
+			}
+		}) / 1e6;
+	}
+} // namespace
+
+// appending never relocates existing elements in a segmented array, the dynamic array relocates on growth
+auto main() -> int {
+	constexpr u64 count = 200'000;
+	const utility::dynamic_string payload("string payload");
+
+	std::printf(
+		"%llu x u64 push_back (50 rounds): dynamic_array %.1f ms, segmented_array %.1f ms\n",
+		static_cast<unsigned long long>(count),
+		run<utility::dynamic_array<u64>>(count, [](u64 i) { return i; }),
+		run<utility::segmented_array<u64>>(count, [](u64 i) { return i; })
+	);
+
+	std::printf(
+		"%llu x dynamic_string push_back (50 rounds): dynamic_array %.1f ms, segmented_array %.1f ms\n",
+		static_cast<unsigned long long>(count / 10),
+		run<utility::dynamic_array<utility::dynamic_string>>(count / 10, [&](u64) -> const auto& { return payload; }),
+		run<utility::segmented_array<utility::dynamic_string>>(count / 10, [&](u64) -> const auto& { return payload; })
+	);
+
+	return 0;
+}
@@ -0,0 +1,37 @@
+#include "benchmarks/benchmark.h"
+#include "utility/containers/small_array.h"
+
+using namespace utility::types;
+
+namespace {
+	// builds and destroys a short array many times, which is where the inline storage pays off
+	template<typename array_type>
+	[[nodiscard]] auto run(u64 size) -> f64 {
+		constexpr u64 rounds = 2'000'000;
+
+		return benchmark::measure([&] {
+			for(u64 r = 0; r < rounds; ++r) {
+				array_type array;
+
+				for(u64 i = 0; i < size; ++i) {
+					array.push_back(i);
+				}
+
+				benchmark::consume(array[size - 1]);
+			}
+		}) / rounds;
+	}
+} // namespace
+
+auto main() -> int {
+	for(const u64 size : { 1, 4, 8 }) {
+		std::printf(
+			"%llu elements: dynamic_array %.1f ns, small_array<8> %.1f ns per array\n",
+			static_cast<unsigned long long>(size),
+			run<utility::dynamic_array<u64>>(size),
+			run<utility::small_array<u64, 8>>(size)
+		);
+	}
+
+	return 0;
+}
@@ -0,0 +1,75 @@
+#include "benchmarks/benchmark.h"
+#include "utility/containers/small_map.h"
+
+#include <random>
+
+using namespace utility::types;
+
+namespace {
+	struct timings {
+		f64 build; // per element, including the construction and destruction of the map
+		f64 find;
+	};
+
+	template<typename map_type>
+	[[nodiscard]] auto run(u64 size, const utility::dynamic_array<u64>& keys) -> timings {
+		const u64 rounds = 2'000'000 / size + 10;
+		constexpr u64 lookups = 20'000'000;
+
+		const f64 build = benchmark::measure([&] {
+			for(u64 r = 0; r < rounds; ++r) {
+				map_type map;
+
+				for(u64 i = 0; i < size; ++i) {
+					map.insert({ keys[i], i });
+				}
+
+				benchmark::consume(map.get_size());
+			}
+		});
+
+		map_type map;
+
+		for(u64 i = 0; i < size; ++i) {
+			map.insert({ keys[i], i });
+		}
+
+		const f64 find = benchmark::measure([&] {
+			u64 sum = 0;
+
+			for(u64 i = 0, j = 0; i < lookups; ++i, j = j + 1 == size ? 0 : j + 1) {
+				sum += map.find(keys[j])->second;
+			}
+
+			benchmark::consume(sum);
+		});
+
+		return { build / static_cast<f64>(rounds * size), find / lookups };
+	}
+} // namespace
+
+auto main() -> int {
+	std::mt19937_64 rng(1);
+	utility::dynamic_array<u64> keys;
+
+	for(u64 i = 0; i < 64; ++i) {
+		keys.push_back(rng());
+	}
+
+	std::printf("   n   build/elem: map  small<16>  small<64>   find: map  small<16>  small<64> (ns)\n");
+
+	for(const u64 size : { 1, 4, 8, 16, 32, 64 }) {
+		const timings m = run<utility::map<u64, u64>>(size, keys);
+		const timings s16 = run<utility::small_map<u64, u64, 16>>(size, keys);
+		const timings s64 = run<utility::small_map<u64, u64, 64>>(size, keys);
+
+		std::printf(
+			"%4llu   %15.1f  %9.1f  %9.1f   %9.1f  %9.1f  %9.1f\n",
+			static_cast<unsigned long long>(size),
+			m.build, s16.build, s64.build,
+			m.find, s16.find, s64.find
+		);
+	}
+
+	return 0;
+}
@@ -0,0 +1,62 @@
+#include "benchmarks/benchmark.h"
+#include "utility/containers/dynamic_array.h"
+#include "utility/containers/soa_array.h"
+
+using namespace utility::types;
+
+namespace {
+	struct particle {
+		f32 x, y, z;
+		f32 vx, vy, vz;
+		f32 mass;
+		u32 id;
+	};
+} // namespace
+
+// sums a single field over every row, the array of structs streams all 32 bytes of every row through the
+// cache while the struct of arrays only touches the mass column
+auto main() -> int {
+	constexpr u64 count = 1 << 20;
+	constexpr u64 rounds = 100;
+
+	utility::dynamic_array<particle> aos;
+	utility::soa_array<f32, f32, f32, f32, f32, f32, f32, u32> soa;
+
+	aos.reserve(count);
+	soa.reserve(count);
+
+	for(u64 i = 0; i < count; ++i) {
+		const f32 mass = static_cast<f32>(i & 7);
+
+		aos.push_back({ 1, 2, 3, 4, 5, 6, mass, static_cast<u32>(i) });
+		soa.push_back(1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, mass, static_cast<u32>(i));
+	}
+
+	const f64 aos_time = benchmark::measure([&] {
+		for(u64 r = 0; r < rounds; ++r) {
+			f32 total = 0;
+
+			for(const particle& p : aos) {
+				total += p.mass;
+			}
+
+			benchmark::consume(static_cast<u64>(total));
+		}
+	});
+
+	const f64 soa_time = benchmark::measure([&] {
+		for(u64 r = 0; r < rounds; ++r) {
+			const f32* mass = soa.get_data<6>();
+			f32 total = 0;
+
+			for(u64 i = 0; i < soa.get_size(); ++i) {
+				total += mass[i];
+			}
+
+			benchmark::consume(static_cast<u64>(total));
+		}
+	});
+
+	std::printf("mass reduction, 1M rows x 100: aos %.1f ms, soa %.1f ms\n", aos_time / 1e6, soa_time / 1e6);
+	return 0;
+}
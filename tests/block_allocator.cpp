@@ -0,0 +1,71 @@
+#include "utility/allocators/block_allocator.h"
+
+#include <cstdio>
+
+using namespace utility::types;
+
+#define CHECK(condition)                                                             \
+	if(!(condition)) {                                                               \
+		std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);   \
+		return 1;                                                                    \
+	}
+
+namespace {
+	struct alignas(64) cache_line {
+		cache_line(u64 value) : value(value) {}
+		u64 value;
+	};
+
+	[[nodiscard]] auto is_aligned(const void* memory, u64 alignment) -> bool {
+		return reinterpret_cast<u64>(memory) % alignment == 0;
+	}
+} // namespace
+
+auto main() -> int {
+	constexpr u64 max_alignment = 4096;
+
+	// every power-of-two alignment, interleaved with unaligned allocations and forced block overflows
+	utility::block_allocator allocator(256);
+
+	for(u64 alignment = 1; alignment <= max_alignment; alignment *= 2) {
+		for(u64 i = 0; i < 32; ++i) {
+			CHECK(allocator.allocate(3) != nullptr);
+
+			void* memory = allocator.allocate(alignment * 2 + 1, alignment);
+			CHECK(memory != nullptr && is_aligned(memory, alignment));
+			utility::memset(memory, 0xAB, alignment * 2 + 1);
+		}
+	}
+
+	// same alignments after rewinding to a safepoint, in descending order
+	const auto safepoint = allocator.create_safepoint();
+
+	for(u64 alignment = 1; alignment <= max_alignment; alignment *= 2) {
+		void* memory = allocator.allocate(5000, alignment);
+		CHECK(is_aligned(memory, alignment));
+		utility::memset(memory, 0, 5000);
+	}
+
+	allocator.restore_safepoint(safepoint);
+
+	for(u64 alignment = max_alignment; alignment >= 1; alignment /= 2) {
+		void* memory = allocator.allocate(9000, alignment);
+		CHECK(is_aligned(memory, alignment));
+		utility::memset(memory, 0, 9000);
+	}
+
+	// typed bulk allocation
+	cache_line* lines = allocator.emplace_array<cache_line>(10, 7ull);
+
+	for(u64 i = 0; i < 10; ++i) {
+		CHECK(lines[i].value == 7 && is_aligned(lines + i, alignof(cache_line)));
+	}
+
+	const f64* values = allocator.allocate_array<f64>(3);
+	CHECK(is_aligned(values, alignof(f64)));
+
+	CHECK(allocator.allocate(0) == nullptr);
+
+	std::printf("block_allocator: ok\n");
+	return 0;
+}
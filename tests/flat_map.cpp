@@ -0,0 +1,57 @@
+#include "utility/containers/flat_map.h"
+
+#include <cstdio>
+
+using namespace utility::types;
+
+#define CHECK(condition)                                                             \
+	if(!(condition)) {                                                               \
+		std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);   \
+		return 1;                                                                    \
+	}
+
+auto main() -> int {
+	// erasing through the result of find()
+	utility::flat_map<u64, u64> map;
+
+	for(u64 i = 0; i < 1000; ++i) {
+		map[i] = i * 2;
+	}
+
+	for(u64 i = 0; i < 1000; i += 2) {
+		const auto it = map.find(i);
+		CHECK(it != map.end());
+
+		map.erase(it);
+		CHECK(!map.contains(i));
+	}
+
+	CHECK(map.get_size() == 500);
+
+	for(u64 i = 1; i < 1000; i += 2) {
+		CHECK(map.at(i) == i * 2);
+	}
+
+	// erase + insert churn at a constant size leaves tombstones behind, the table must not keep growing
+	utility::flat_map<u64, u64> churn;
+	churn.reserve(870);
+
+	for(u64 i = 0; i < 870; ++i) {
+		churn.insert({ i, i });
+	}
+
+	const u64 memory_usage = churn.get_memory_usage();
+
+	for(u64 i = 870; i < 100'000; ++i) {
+		const auto it = churn.find(i - 870);
+		CHECK(it != churn.end() && it->second == i - 870);
+
+		churn.erase(it);
+		churn.insert({ i, i });
+	}
+
+	CHECK(churn.get_size() == 870 && churn.get_memory_usage() <= memory_usage * 2);
+
+	std::printf("flat_map: ok\n");
+	return 0;
+}
@@ -0,0 +1,105 @@
+#include "utility/containers/lru_cache.h"
+
+#include <cstdio>
+
+using namespace utility::types;
+
+#define CHECK(condition)                                                             \
+	if(!(condition)) {                                                               \
+		std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);   \
+		return 1;                                                                    \
+	}
+
+namespace {
+	i64 g_live_values = 0;
+
+	// move-only and not default constructible, the cache must neither copy nor default construct values
+	class handle {
+	public:
+		explicit handle(u64 id) : m_id(new u64(id)) {
+			++g_live_values;
+		}
+		handle(handle&& other) noexcept : m_id(utility::exchange(other.m_id, nullptr)) {}
+		handle(const handle& other) = delete;
+
+		~handle() {
+			if(m_id) {
+				--g_live_values;
+				delete m_id;
+			}
+		}
+
+		auto operator=(handle&& other) noexcept -> handle& {
+			if(this != &other) {
+				this->~handle();
+				m_id = utility::exchange(other.m_id, nullptr);
+			}
+
+			return *this;
+		}
+		auto operator=(const handle& other) -> handle& = delete;
+
+		[[nodiscard]] auto get_id() const -> u64 {
+			return *m_id;
+		}
+	private:
+		u64* m_id;
+	};
+
+	template<utility::cache_policy policy>
+	[[nodiscard]] auto run() -> bool {
+		{
+			utility::lru_cache<u64, handle, policy> cache(4);
+
+			for(u64 i = 0; i < 4; ++i) {
+				if(!cache.put(i, handle(i))) {
+					return false;
+				}
+			}
+
+			// replacing, evicting and erasing all destroy exactly one value
+			cache.put(2, handle(20));
+			cache.put(10, handle(10));
+
+			const handle* replaced = cache.peek(2);
+
+			if(replaced == nullptr || replaced->get_id() != 20 || cache.get_size() != 4 || g_live_values != 4) {
+				return false;
+			}
+
+			if(cache.erase(2) != 1 || cache.contains(2) || cache.get_size() != 3 || g_live_values != 3) {
+				return false;
+			}
+
+			for(u64 i = 100; i < 110; ++i) {
+				cache.put(i, handle(i));
+				const handle* value = cache.get(i);
+
+				if(value == nullptr || value->get_id() != i || cache.get_size() > 4) {
+					return false;
+				}
+			}
+
+			// byte budget evictions go through the same removal path
+			utility::lru_cache<u64, handle, policy> budget(8, 100);
+
+			for(u64 i = 0; i < 8; ++i) {
+				budget.put(i, handle(i), 30);
+			}
+
+			if(budget.get_size() != 3 || budget.get_bytes() != 90 || !budget.contains(7)) {
+				return false;
+			}
+		}
+
+		return g_live_values == 0;
+	}
+} // namespace
+
+auto main() -> int {
+	CHECK(run<utility::cache_policy::lru>());
+	CHECK(run<utility::cache_policy::clock>());
+
+	std::printf("lru_cache: ok\n");
+	return 0;
+}
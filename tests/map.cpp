@@ -0,0 +1,231 @@
+#include "utility/containers/map.h"
+
+#include <array>
+#include <cstdio>
+#include <random>
+#include <unordered_map>
+
+using namespace utility::types;
+
+#define CHECK(condition)                                                             \
+	if(!(condition)) {                                                               \
+		std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);   \
+		return 1;                                                                    \
+	}
+
+namespace {
+	// maps every key to one of 16 hashes whose remixed value has all top bits set, every key homes in the
+	// last buckets, which produces long probe sequences and shifts across the wrap around of the buckets
+	struct tail_hash {
+		auto operator()(u64 k) const -> u64 {
+			static const auto hashes = [] {
+				std::array<u64, 16> result = {};
+
+				for(u64 candidate = 0, found = 0; found < result.size(); ++candidate) {
+					if(utility::compute_hash(candidate) >> 56 == 0xff) {
+						result[found++] = candidate;
+					}
+				}
+
+				return result;
+			}();
+
+			return hashes[k & 0xf];
+		}
+	};
+
+	// compares the map against std::unordered_map element by element
+	template<typename map_type>
+	[[nodiscard]] auto matches(const map_type& map, const std::unordered_map<u64, u64>& reference) -> bool {
+		if(map.get_size() != reference.size()) {
+			return false;
+		}
+
+		for(const auto& [k, v] : reference) {
+			const auto it = map.find(k);
+
+			if(it == map.end() || it->first != k || it->second != v) {
+				return false;
+			}
+		}
+
+		for(const auto& [k, v] : map) {
+			const auto it = reference.find(k);
+
+			if(it == reference.end() || it->second != v) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	// batched lookups have to agree with find(), they consult both bucket arrays during a migration
+	template<typename map_type>
+	[[nodiscard]] auto matches_batch(const map_type& map, u64 key_range) -> bool {
+		constexpr u64 count = 64;
+		u64 keys[count];
+		typename map_type::const_iterator results[count];
+
+		for(u64 i = 0; i < count; ++i) {
+			keys[i] = (i * 7919) % key_range;
+		}
+
+		map.find_batch(keys, count, results);
+
+		for(u64 i = 0; i < count; ++i) {
+			if(results[i] != map.find(keys[i])) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	// random inserts (try_emplace() and insert()), erases (by key and through find()), overwrites and lookups on a key range small
+	// enough for every operation to hit regularly, the size drifts up and down to exercise growth;
+	// \b rehash_step enables incremental rehashing
+	template<typename hash>
+	[[nodiscard]] auto run_random(u64 seed, u64 operation_count, u64 key_range, u64 rehash_step = 0) -> bool {
+		utility::map<u64, u64, hash> map;
+		std::unordered_map<u64, u64> reference;
+		std::mt19937_64 rng(seed);
+		u64 migrations = 0;
+
+		map.set_incremental_rehash(rehash_step);
+
+		for(u64 i = 0; i < operation_count; ++i) {
+			const u64 k = rng() % key_range;
+			const u64 v = rng();
+
+			// insert heavy during the first half, erase heavy during the second half
+			const u64 insert_weight = i < operation_count / 2 ? 6 : 3;
+			const u64 operation = rng() % 10;
+
+			if(operation < insert_weight) {
+				const bool inserted = rng() % 2 ? map.try_emplace(k, v).second : map.insert({ k, v }).second;
+
+				if(inserted != reference.try_emplace(k, v).second) {
+					return false;
+				}
+			}
+			else if(operation < 7) {
+				if(map.erase(k) != reference.erase(k)) {
+					return false;
+				}
+			}
+			else if(operation < 8) {
+				const auto it = map.find(k);
+
+				if((it != map.end()) != reference.contains(k)) {
+					return false;
+				}
+
+				if(it != map.end()) {
+					map.erase(it);
+					reference.erase(k);
+				}
+			}
+			else if(operation < 9) {
+				map[k] = v;
+				reference[k] = v;
+			}
+			else {
+				const auto it = map.find(k);
+				const auto expected = reference.find(k);
+
+				if((it == map.end()) != (expected == reference.end()) || (it != map.end() && it->second != expected->second)) {
+					return false;
+				}
+			}
+
+			migrations += map.is_rehashing();
+
+			if(i % 1024 == 0 && (!matches(map, reference) || !matches_batch(map, key_range))) {
+				return false;
+			}
+
+			// copies of a map which is mid-migration build a single bucket array
+			if(i % 4096 == 0 && map.is_rehashing()) {
+				const utility::map<u64, u64, hash> copy = map;
+
+				if(copy.is_rehashing() || !matches(copy, reference)) {
+					return false;
+				}
+			}
+		}
+
+		// make sure the incremental path actually ran
+		if((rehash_step > 0) != (migrations > 0)) {
+			return false;
+		}
+
+		map.complete_rehash();
+		return !map.is_rehashing() && matches(map, reference);
+	}
+} // namespace
+
+auto main() -> int {
+	// erasing through the result of find()
+	utility::map<u64, u64> map;
+
+	for(u64 i = 0; i < 1000; ++i) {
+		map[i] = i * 2;
+	}
+
+	for(u64 i = 0; i < 1000; i += 2) {
+		const auto it = map.find(i);
+		CHECK(it != map.end());
+
+		map.erase(it);
+		CHECK(!map.contains(i));
+	}
+
+	CHECK(map.get_size() == 500);
+
+	for(u64 i = 1; i < 1000; i += 2) {
+		CHECK(map.at(i) == i * 2);
+	}
+
+	// backward-shift deletion against a reference
+	for(u64 seed = 0; seed < 4; ++seed) {
+		CHECK(run_random<utility::hash<u64>>(seed, 200'000, 5000));
+		CHECK(run_random<tail_hash>(seed, 20'000, 300));
+	}
+
+	// the same with incremental rehashing, small steps keep a migration pending across many operations
+	for(const u64 step : { 1, 2, 8 }) {
+		for(u64 seed = 0; seed < 4; ++seed) {
+			CHECK(run_random<utility::hash<u64>>(seed, 200'000, 5000, step));
+			CHECK(run_random<tail_hash>(seed, 20'000, 300, step));
+		}
+	}
+
+	// reserve() and erase_if() complete or cope with a pending migration
+	utility::map<u64, u64> growing;
+	growing.set_incremental_rehash(1);
+
+	u64 inserted = 0;
+
+	while(!growing.is_rehashing() && inserted < 10'000) {
+		growing[inserted] = inserted;
+		++inserted;
+	}
+
+	CHECK(growing.is_rehashing());
+	CHECK(growing.erase_if([](const auto& element) { return element.first % 3 == 0; }) > 0);
+
+	for(const auto& [k, v] : growing) {
+		CHECK(k % 3 != 0 && growing.find(k)->second == v);
+	}
+
+	growing.reserve(100'000);
+	CHECK(!growing.is_rehashing());
+
+	for(u64 i = 0; i < inserted; ++i) {
+		CHECK(growing.contains(i) == (i % 3 != 0));
+	}
+
+	std::printf("map: ok\n");
+	return 0;
+}
@@ -0,0 +1,125 @@
+#include "utility/containers/small_map.h"
+#include "utility/containers/dynamic_string.h"
+
+#include <cstdio>
+
+using namespace utility::types;
+
+#define CHECK(condition)                                                             \
+	if(!(condition)) {                                                               \
+		std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);   \
+		return 1;                                                                    \
+	}
+
+namespace {
+	u64 g_key_constructions = 0;
+
+	// key which counts how often it's constructed, lookups by u64 are transparent
+	struct tracked_key {
+		tracked_key() = default;
+		tracked_key(u64 value) : value(value) {
+			++g_key_constructions;
+		}
+
+		u64 value = 0;
+	};
+
+	struct tracked_hash {
+		using is_transparent = void;
+
+		auto operator()(const tracked_key& k) const -> u64 {
+			return utility::compute_hash(k.value);
+		}
+		auto operator()(u64 k) const -> u64 {
+			return utility::compute_hash(k);
+		}
+	};
+
+	struct tracked_equal {
+		using is_transparent = void;
+
+		auto operator()(const tracked_key& a, const tracked_key& b) const -> bool {
+			return a.value == b.value;
+		}
+		auto operator()(u64 a, const tracked_key& b) const -> bool {
+			return a == b.value;
+		}
+		auto operator()(const tracked_key& a, u64 b) const -> bool {
+			return a.value == b;
+		}
+	};
+
+	template<u64 count>
+	using tracked_map = utility::small_map<tracked_key, u64, count, tracked_hash, tracked_equal>;
+
+	// the same checks run on a map which stays inline and on one which outgrew its inline storage
+	template<u64 count>
+	[[nodiscard]] auto run(u64 size) -> bool {
+		tracked_map<count> map;
+
+		for(u64 i = 0; i < size; ++i) {
+			map[i] = i;
+		}
+
+		if(map.is_large() != (size > count)) {
+			return false;
+		}
+
+		// transparent lookups of existing keys don't construct a key
+		g_key_constructions = 0;
+
+		for(u64 i = 0; i < size; ++i) {
+			if(map[i] != i || map.try_emplace(i, u64(0)).second || map.at(i) != i) {
+				return false;
+			}
+		}
+
+		if(g_key_constructions != 0) {
+			return false;
+		}
+
+		// erase through find(), then erase_if
+		map.erase(map.find(u64(0)));
+
+		if(map.contains(u64(0)) || map.get_size() != size - 1) {
+			return false;
+		}
+
+		if(map.erase_if([](const auto& element) { return element.second % 2 == 1; }) != size / 2) {
+			return false;
+		}
+
+		for(u64 i = 1; i < size; ++i) {
+			if(map.contains(i) != (i % 2 == 0)) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+} // namespace
+
+auto main() -> int {
+	CHECK(run<16>(10));
+	CHECK(run<16>(40));
+
+	// string keys, a literal doesn't have to be turned into a dynamic_string for a lookup
+	utility::small_map<utility::dynamic_string, u64, 4> strings;
+
+	strings["one"] = 1;
+	strings[utility::dynamic_string("two")] = 2;
+	strings.try_emplace(utility::dynamic_string("three"), 3u);
+
+	CHECK(strings["one"] == 1 && strings["two"] == 2 && strings.at("three") == 3);
+	CHECK(strings.get_size() == 3 && !strings.is_large());
+
+	for(const char* name : { "four", "five", "six" }) {
+		strings[name] = 0;
+	}
+
+	CHECK(strings.is_large() && strings.get_size() == 6 && strings["one"] == 1);
+	CHECK(strings.erase_if([](const auto& element) { return element.second == 0; }) == 3);
+
+	std::printf("small_map: ok\n");
+	return 0;
+}
@@ -0,0 +1,65 @@
+#include "utility/allocators/virtual_allocator.h"
+
+#include <cstdio>
+
+using namespace utility::types;
+
+#define CHECK(condition)                                                             \
+	if(!(condition)) {                                                               \
+		std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition);   \
+		return 1;                                                                    \
+	}
+
+namespace {
+	[[nodiscard]] auto is_aligned(const void* memory, u64 alignment) -> bool {
+		return reinterpret_cast<u64>(memory) % alignment == 0;
+	}
+} // namespace
+
+auto main() -> int {
+	constexpr u64 granularity = 64 * 1024;
+	constexpr u64 huge_page_size = 2 * 1024 * 1024;
+
+	// every alignment up to the commit granularity, interleaved with unaligned allocations
+	utility::virtual_allocator allocator(u64(1) << 30);
+
+	for(u64 alignment = 1; alignment <= granularity; alignment *= 2) {
+		CHECK(allocator.allocate(3) != nullptr);
+
+		void* memory = allocator.allocate(alignment + 1, alignment);
+		CHECK(memory != nullptr && is_aligned(memory, alignment));
+		utility::memset(memory, 0xAB, alignment + 1);
+	}
+
+	// the first allocation sits at the base, which is aligned to the commit granularity
+	utility::virtual_allocator fresh(u64(1) << 20);
+	CHECK(is_aligned(fresh.allocate(1), granularity));
+
+	// with huge pages the base is aligned to 2MB, this way every committed granule can be a huge page
+	for(u64 i = 0; i < 8; ++i) {
+		utility::virtual_allocator huge(huge_page_size * 4 + i * 4096, true);
+
+		CHECK(huge.get_reserved_bytes() % huge_page_size == 0);
+
+		void* memory = huge.allocate(huge_page_size, huge_page_size);
+		CHECK(memory != nullptr && is_aligned(memory, huge_page_size));
+		utility::memset(memory, 0, huge_page_size);
+
+		void* second = huge.allocate(1, huge_page_size);
+		CHECK(second == static_cast<u8*>(memory) + huge_page_size);
+	}
+
+	// the range stays usable after moving the allocator and restoring a safepoint
+	utility::virtual_allocator moved = utility::move(allocator);
+	const auto safepoint = moved.create_safepoint();
+
+	void* memory = moved.allocate(granularity * 3, granularity);
+	CHECK(memory != nullptr && is_aligned(memory, granularity));
+	utility::memset(memory, 1, granularity * 3);
+
+	moved.restore_safepoint(safepoint);
+	CHECK(moved.allocate(granularity, granularity) == memory);
+
+	std::printf("virtual_allocator: ok\n");
+	return 0;
+}
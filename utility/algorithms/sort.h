@@ -21,8 +21,8 @@ namespace utility {
 			}
 		}
 
-		buffer.insert(buffer.end(), left, middle);
-		buffer.insert(buffer.end(), right, last);
+		buffer.append(left, middle);
+		buffer.append(right, last);
 
 		move(buffer.begin(), buffer.end(), first);
 	}
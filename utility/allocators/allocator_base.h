@@ -6,4 +6,66 @@ namespace utility {
 
 	template<typename type>
 	concept allocator = std::derived_from<type, allocator_base>;
+
+	/**
+	 * \brief Default, stateless allocator used by containers, forwards to utility::malloc/utility::free.
+	 * Container allocators have to provide allocate(size, alignment), deallocate(memory, size) and
+	 * try_expand(memory, size, new_size).
+	 */
+	class heap_allocator : public allocator_base {
+	public:
+		[[nodiscard]] static auto allocate(u64 size, u64 alignment = 1) -> void* {
+			ASSERT(alignment <= alignof(std::max_align_t), "unsupported heap alignment\n");
+			SUPPRESS_C4100(alignment);
+			return utility::malloc(size);
+		}
+
+		static void deallocate(void* memory, u64 size) {
+			SUPPRESS_C4100(size);
+			utility::free(memory);
+		}
+
+		/**
+		 * \brief Attempts to grow an allocation in place.
+		 * \return True if the allocation now spans at least \b new_size bytes, false otherwise.
+		 */
+		[[nodiscard]] static auto try_expand(void* memory, u64 size, u64 new_size) -> bool {
+			SUPPRESS_C4100(size);
+			return utility::try_expand(memory, new_size);
+		}
+	};
+
+	namespace detail {
+		/**
+		 * \brief Reference to the allocator used by a container. Stateful allocators (ie. arenas) are
+		 * referenced through a pointer, stateless allocators take up no space at all.
+		 */
+		template<typename type, bool = __is_empty(type)>
+		class allocator_reference {
+		public:
+			allocator_reference() : m_allocator(nullptr) {}
+			allocator_reference(type& allocator) : m_allocator(&allocator) {}
+
+			[[nodiscard]] auto get() const -> type& {
+				ASSERT(m_allocator, "container has no allocator\n");
+				return *m_allocator;
+			}
+		private:
+			type* m_allocator;
+		};
+
+		template<typename type>
+		class allocator_reference<type, true> {
+		public:
+			allocator_reference() = default;
+			allocator_reference(type& allocator) {
+				SUPPRESS_C4100(allocator);
+			}
+
+			[[nodiscard]] auto get() const -> type& {
+				static type instance;
+				return instance;
+			}
+		};
+	} // namespace detail
 } // namespace utility
@@ -2,17 +2,32 @@
 #include "utility/allocators/allocator_base.h"
 
 namespace utility {
-	// TODO: aligned allocations
+	/**
+	 * \brief Determines the size of newly allocated blocks.
+	 */
+	enum class growth_policy {
+		fixed,    // every block has the same size
+		geometric // every new block is twice as large as the previous one, up to a set cap
+	};
+
+	struct block_allocator_stats {
+		u64 block_count;     // number of blocks owned by the allocator
+		u64 bytes_reserved;  // sum of the capacities of all blocks
+		u64 bytes_used;      // bytes handed out (including alignment padding) since the last clear
+		u64 high_water_mark; // largest value of bytes_used observed since the last clear
+	};
+
 	class block_allocator : public allocator_base {
 	protected:
 		struct block {
-			block(u8* memory) : memory(memory), position(0) {}
+			block(u8* memory, u64 capacity) : memory(memory), position(0), capacity(capacity) {}
 			~block() {
 				utility::free(memory);
 			}
 
 			u8* memory;
 			u64 position;
+			u64 capacity;
 			block* next = nullptr;
 		};
 	public:
@@ -33,7 +48,16 @@ namespace utility {
 			u64 m_position;
 		};
 
-		block_allocator(u64 block_size) : m_block_size(block_size) {
+		block_allocator(u64 block_size) : block_allocator(block_size, growth_policy::fixed, block_size) {}
+
+		/**
+		 * \brief Creates a new block allocator.
+		 * \param block_size Size of the first block
+		 * \param policy Growth policy used when allocating subsequent blocks
+		 * \param max_block_size Largest block size the geometric policy will grow to
+		 */
+		block_allocator(u64 block_size, growth_policy policy, u64 max_block_size)
+			: m_block_size(block_size), m_max_block_size(max(block_size, max_block_size)), m_policy(policy) {
 			clear();
 		}
 
@@ -45,57 +69,133 @@ namespace utility {
 		block_allocator& operator=(const block_allocator& other) = delete;
 		block_allocator& operator=(block_allocator&& other) {
 			if(&other != this) {
+				free_blocks();
+
 				m_first_block = exchange(other.m_first_block, nullptr);
-				m_current_block = exchange(other.m_first_block, nullptr);
+				m_current_block = exchange(other.m_current_block, nullptr);
 				m_block_size = exchange(other.m_block_size, 0);
+				m_next_block_size = exchange(other.m_next_block_size, 0);
+				m_max_block_size = exchange(other.m_max_block_size, 0);
+				m_policy = other.m_policy;
+				m_previous_used = exchange(other.m_previous_used, 0);
+				m_high_water_mark = exchange(other.m_high_water_mark, 0);
+				m_bytes_reserved = exchange(other.m_bytes_reserved, 0);
+				m_block_count = exchange(other.m_block_count, 0);
 			}
 
 			return *this;
 		}
 
 		~block_allocator() {
-			while(m_first_block) {
-				block* temp = m_first_block;
-				m_first_block = m_first_block->next;
-				delete temp;
-			}
+			free_blocks();
 		}
 
 		void clear() {
-			while(m_first_block) {
-				block* temp = m_first_block;
-				m_first_block = m_first_block->next;
-				delete temp;
-			}
+			free_blocks();
 
 			m_first_block = nullptr;
 			m_current_block = nullptr;
+			m_next_block_size = m_block_size;
+			m_previous_used = 0;
+			m_high_water_mark = 0;
 
 			allocate_block(m_block_size); // allocate the first block
 			m_first_block = m_current_block;
 		}
 
-		[[nodiscard]] auto allocate(u64 size) -> void* {
-			// ASSERT(size <= m_block_size, "insufficient block size for allocation of {}B\n", size);
+		/**
+		 * \brief Allocates \b size bytes aligned to \b alignment from the current block. If the aligned
+		 * allocation doesn't fit into the remaining space a new block is used.
+		 * \param size Size of the allocation in bytes
+		 * \param alignment Alignment of the allocation, has to be a power of two
+		 * \return Pointer to the beginning of the allocated memory.
+		 */
+		[[nodiscard]] auto allocate(u64 size, u64 alignment = 1) -> void* {
+			ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0, "alignment has to be a power of two\n");
 
 			if(size == 0) {
 				return nullptr;
 			}
 
-			// if this allocation incurs a buffer overflow allocate a new block
-			if(m_current_block->position + size >= m_block_size) {
-				allocate_block(max(m_block_size, size));
+			u64 position = aligned_position(m_current_block, alignment);
+
+			// if this allocation incurs a buffer overflow allocate a new block, the new block has
+			// to be large enough to accommodate the worst-case alignment padding
+			if(position + size > m_current_block->capacity) {
+				allocate_block(size + alignment - 1);
+				position = aligned_position(m_current_block, alignment);
 			}
 
-			void* memory = m_current_block->memory + m_current_block->position;
-			m_current_block->position += size;
+			void* memory = m_current_block->memory + position;
+			m_current_block->position = position + size;
 
 			return memory;
 		}
 
+		/**
+		 * \brief Releases an allocation. Memory is only reclaimed if \b memory is the most recent
+		 * allocation in the current block, otherwise it's released by the next safepoint restore/clear.
+		 * \param memory Memory previously returned by allocate()
+		 * \param size Size of the allocation in bytes
+		 */
+		void deallocate(void* memory, u64 size) {
+			if(is_last_allocation(memory, size)) {
+				update_high_water_mark();
+				m_current_block->position -= size;
+			}
+		}
+
+		/**
+		 * \brief Attempts to grow an allocation in place, which is possible if \b memory is the most
+		 * recent allocation and the current block has enough space left.
+		 * \param memory Memory previously returned by allocate()
+		 * \param size Current size of the allocation in bytes
+		 * \param new_size Requested size of the allocation in bytes
+		 * \return True if the allocation was expanded, false otherwise.
+		 */
+		[[nodiscard]] auto try_expand(void* memory, u64 size, u64 new_size) -> bool {
+			if(!is_last_allocation(memory, size)) {
+				return false;
+			}
+
+			const u64 start = static_cast<u8*>(memory) - m_current_block->memory;
+
+			if(start + new_size > m_current_block->capacity) {
+				return false;
+			}
+
+			m_current_block->position = start + new_size;
+			return true;
+		}
+
+		/**
+		 * \brief Allocates uninitialized, correctly aligned storage for \b count objects of type \b type.
+		 * \param count Number of objects to allocate storage for
+		 */
+		template<typename type>
+		[[nodiscard]] auto allocate_array(u64 count) -> type* {
+			return static_cast<type*>(allocate(sizeof(type) * count, alignof(type)));
+		}
+
 		template<typename type, typename... value_types>
 		[[nodiscard]] auto emplace(value_types&&... values) -> type* {
-			return new (allocate(sizeof(type))) type(forward<value_types>(values)...);
+			return new (allocate(sizeof(type), alignof(type))) type(forward<value_types>(values)...);
+		}
+
+		/**
+		 * \brief Allocates and constructs \b count objects of type \b type, every object is constructed
+		 * from the same \b values.
+		 * \param count Number of objects to construct
+		 */
+		template<typename type, typename... value_types>
+		[[nodiscard]] auto emplace_array(u64 count, const value_types&... values) -> type* {
+			type* memory = allocate_array<type>(count);
+
+			for(u64 i = 0; i < count; ++i) {
+				new (memory + i) type(values...);
+			}
+
+			return memory;
 		}
 
 		auto create_safepoint() const -> safepoint {
@@ -103,6 +203,8 @@ namespace utility {
 		}
 
 		void restore_safepoint(const safepoint& safepoint) {
+			update_high_water_mark();
+
 			// restore the first block
 			m_current_block = safepoint.get_block();
 			m_current_block->position = safepoint.get_position();
@@ -114,31 +216,139 @@ namespace utility {
 				current->position = 0;
 				current = current->next;
 			}
+
+			// recalculate the usage of all blocks in front of the restored one
+			m_previous_used = 0;
+
+			for(current = m_first_block; current != m_current_block; current = current->next) {
+				m_previous_used += current->position;
+			}
+		}
+
+		/**
+		 * \brief Frees unused blocks following the current block, blocks are kept for as long as
+		 * their combined capacity doesn't exceed \b keep_bytes. Usually called after restoring
+		 * a safepoint in order to return memory after a peak.
+		 * \param keep_bytes Number of bytes which can be kept around for later reuse
+		 */
+		void trim(u64 keep_bytes = 0) {
+			block* last_kept = m_current_block;
+			u64 kept = 0;
+
+			while(last_kept->next && kept + last_kept->next->capacity <= keep_bytes) {
+				last_kept = last_kept->next;
+				kept += last_kept->capacity;
+			}
+
+			block* current = exchange(last_kept->next, nullptr);
+
+			while(current) {
+				block* temp = current;
+				current = current->next;
+
+				m_bytes_reserved -= temp->capacity;
+				--m_block_count;
+				delete temp;
+			}
+		}
+
+		[[nodiscard]] auto get_reserved_bytes() const -> u64 {
+			return m_bytes_reserved;
+		}
+
+		[[nodiscard]] auto get_stats() -> block_allocator_stats {
+			update_high_water_mark();
+
+			return {
+				.block_count = m_block_count,
+				.bytes_reserved = m_bytes_reserved,
+				.bytes_used = get_used_bytes(),
+				.high_water_mark = m_high_water_mark
+			};
 		}
 	protected:
-		void allocate_block(u64 size) {
+		[[nodiscard]] static auto aligned_position(const block* b, u64 alignment) -> u64 {
+			const u64 address = reinterpret_cast<u64>(b->memory + b->position);
+			return b->position + (((address + alignment - 1) & ~(alignment - 1)) - address);
+		}
+
+		[[nodiscard]] auto is_last_allocation(void* memory, u64 size) const -> bool {
+			const u8* bytes = static_cast<u8*>(memory);
+			return bytes >= m_current_block->memory && bytes + size == m_current_block->memory + m_current_block->position;
+		}
+
+		[[nodiscard]] auto get_used_bytes() const -> u64 {
+			return m_previous_used + m_current_block->position;
+		}
+
+		void update_high_water_mark() {
+			// usage only grows between block switches, safepoint restores and clears, so the
+			// peak doesn't have to be tracked in the allocation path
+			if(m_current_block) {
+				m_high_water_mark = max(m_high_water_mark, get_used_bytes());
+			}
+		}
+
+		void allocate_block(u64 required_size) {
+			if(m_current_block) {
+				update_high_water_mark();
+				m_previous_used += m_current_block->position;
+			}
+
 			// the current block already has a valid block after it, use that, this is a
 			// byproduct of safepoints
-			if(m_current_block && m_current_block->next) {
+			if(m_current_block && m_current_block->next && m_current_block->next->capacity >= required_size) {
 				m_current_block = m_current_block->next;
 				return;
 			}
 
+			const u64 size = max(m_next_block_size, required_size);
+
+			if(m_policy == growth_policy::geometric) {
+				m_next_block_size = min(m_next_block_size * 2, m_max_block_size);
+			}
+
 			const auto memory = static_cast<u8*>(utility::malloc(size));
 			ASSERT(memory, "allocation failure\n");
 
-			const auto new_block = new block(memory);
+			const auto new_block = new block(memory, size);
 
+			m_bytes_reserved += size;
+			++m_block_count;
+
+			// if the following block is too small for this allocation we insert the new block
+			// in front of it so that it can still be reused later
 			if(m_current_block) {
+				new_block->next = m_current_block->next;
 				m_current_block->next = new_block;
 			}
 
 			m_current_block = new_block;
 		}
+
+		void free_blocks() {
+			while(m_first_block) {
+				block* temp = m_first_block;
+				m_first_block = m_first_block->next;
+				delete temp;
+			}
+
+			m_bytes_reserved = 0;
+			m_block_count = 0;
+		}
 	protected:
 		block* m_first_block = nullptr;
 		block* m_current_block = nullptr;
 
 		u64 m_block_size;
+		u64 m_next_block_size = 0;
+		u64 m_max_block_size = 0;
+		growth_policy m_policy = growth_policy::fixed;
+
+		// statistics
+		u64 m_previous_used = 0;   // bytes used in blocks in front of the current block
+		u64 m_high_water_mark = 0;
+		u64 m_bytes_reserved = 0;
+		u64 m_block_count = 0;
 	};
 } // namespace utility
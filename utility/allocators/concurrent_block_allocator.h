@@ -0,0 +1,185 @@
+#pragma once
+#include "utility/allocators/allocator_base.h"
+
+#include <atomic>
+#include <mutex>
+
+namespace utility {
+	/**
+	 * \brief Thread-safe variant of the block allocator. Memory is handed out via an atomic fetch-add on
+	 * the current block, the lock is only taken when a new block has to be installed.
+	 */
+	class concurrent_block_allocator : public allocator_base {
+	protected:
+		struct block {
+			block(u8* memory, u64 capacity) : memory(memory), capacity(capacity), position(0) {}
+			~block() {
+				utility::free(memory);
+			}
+
+			u8* memory;
+			u64 capacity;
+			std::atomic<u64> position;
+			block* next = nullptr;
+		};
+	public:
+		/**
+		 * \brief Per-thread allocation cache. Grabs sub-chunks from the shared allocator and then bumps
+		 * through them without any synchronization. A cache must only be used by a single thread.
+		 */
+		class cache {
+		public:
+			cache(concurrent_block_allocator& allocator, u64 chunk_size)
+				: m_allocator(allocator), m_chunk_size(chunk_size) {}
+
+			[[nodiscard]] auto allocate(u64 size, u64 alignment = 1) -> void* {
+				ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0, "alignment has to be a power of two\n");
+
+				if(size == 0) {
+					return nullptr;
+				}
+
+				// large allocations would waste most of the chunk, forward them
+				if(size + alignment - 1 > m_chunk_size / 2) {
+					return m_allocator.allocate(size, alignment);
+				}
+
+				u8* memory = align_pointer(m_position, alignment);
+
+				if(m_position == nullptr || memory + size > m_end) {
+					m_position = static_cast<u8*>(m_allocator.allocate(m_chunk_size, alignof(std::max_align_t)));
+					m_end = m_position + m_chunk_size;
+					memory = align_pointer(m_position, alignment);
+				}
+
+				m_position = memory + size;
+				return memory;
+			}
+
+			template<typename type, typename... value_types>
+			[[nodiscard]] auto emplace(value_types&&... values) -> type* {
+				return new (allocate(sizeof(type), alignof(type))) type(forward<value_types>(values)...);
+			}
+
+			/**
+			 * \brief Drops the current chunk, has to be called after the shared allocator is cleared.
+			 */
+			void reset() {
+				m_position = nullptr;
+				m_end = nullptr;
+			}
+		private:
+			concurrent_block_allocator& m_allocator;
+			u64 m_chunk_size;
+
+			u8* m_position = nullptr;
+			u8* m_end = nullptr;
+		};
+
+		concurrent_block_allocator(u64 block_size) : m_block_size(block_size) {
+			clear();
+		}
+
+		concurrent_block_allocator(const concurrent_block_allocator& other) = delete;
+		concurrent_block_allocator& operator=(const concurrent_block_allocator& other) = delete;
+
+		~concurrent_block_allocator() {
+			free_blocks();
+		}
+
+		/**
+		 * \brief Frees every block and starts over with a fresh block of the initial size. Not thread-safe.
+		 */
+		void clear() {
+			free_blocks();
+
+			block* first = create_block(m_block_size);
+			m_first_block = first;
+			m_last_block = first;
+			m_current_block.store(first, std::memory_order_release);
+		}
+
+		/**
+		 * \brief Allocates \b size bytes aligned to \b alignment, can be called from multiple threads at once.
+		 * \param size Size of the allocation in bytes
+		 * \param alignment Alignment of the allocation, has to be a power of two
+		 * \return Pointer to the beginning of the allocated memory.
+		 */
+		[[nodiscard]] auto allocate(u64 size, u64 alignment = 1) -> void* {
+			ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0, "alignment has to be a power of two\n");
+
+			if(size == 0) {
+				return nullptr;
+			}
+
+			// reserve enough space for the worst-case alignment padding, this way a single fetch-add
+			// is enough to claim the allocation
+			const u64 padded_size = size + alignment - 1;
+
+			while(true) {
+				block* current = m_current_block.load(std::memory_order_acquire);
+				const u64 position = current->position.fetch_add(padded_size, std::memory_order_relaxed);
+
+				if(position + padded_size <= current->capacity) {
+					return align_pointer(current->memory + position, alignment);
+				}
+
+				install_block(current, padded_size);
+			}
+		}
+
+		template<typename type, typename... value_types>
+		[[nodiscard]] auto emplace(value_types&&... values) -> type* {
+			return new (allocate(sizeof(type), alignof(type))) type(forward<value_types>(values)...);
+		}
+
+		[[nodiscard]] auto create_cache(u64 chunk_size) -> cache {
+			return { *this, chunk_size };
+		}
+	protected:
+		[[nodiscard]] static auto align_pointer(u8* pointer, u64 alignment) -> u8* {
+			const u64 address = reinterpret_cast<u64>(pointer);
+			return pointer + (((address + alignment - 1) & ~(alignment - 1)) - address);
+		}
+
+		[[nodiscard]] static auto create_block(u64 size) -> block* {
+			const auto memory = static_cast<u8*>(utility::malloc(size));
+			ASSERT(memory, "allocation failure\n");
+
+			return new block(memory, size);
+		}
+
+		void install_block(block* exhausted, u64 required_size) {
+			std::lock_guard lock(m_mutex);
+
+			// another thread has already replaced the exhausted block
+			if(m_current_block.load(std::memory_order_acquire) != exhausted) {
+				return;
+			}
+
+			block* new_block = create_block(max(m_block_size, required_size));
+
+			m_last_block->next = new_block;
+			m_last_block = new_block;
+			m_current_block.store(new_block, std::memory_order_release);
+		}
+
+		void free_blocks() {
+			while(m_first_block) {
+				block* temp = m_first_block;
+				m_first_block = m_first_block->next;
+				delete temp;
+			}
+
+			m_last_block = nullptr;
+			m_current_block.store(nullptr, std::memory_order_relaxed);
+		}
+	protected:
+		std::atomic<block*> m_current_block = nullptr;
+		block* m_first_block = nullptr;
+		block* m_last_block = nullptr;
+		std::mutex m_mutex;
+
+		u64 m_block_size;
+	};
+} // namespace utility
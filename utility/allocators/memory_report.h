@@ -0,0 +1,33 @@
+#pragma once
+#include "utility/allocators/memory_tracker.h"
+#include "utility/assert.h"
+
+namespace utility {
+	/**
+	 * \brief Prints the per-tag allocation statistics collected by the memory tracker.
+	 */
+	inline void print_memory_report() {
+#ifdef UTILITY_MEMORY_TRACKING
+		console::print("memory usage report:\n");
+
+		for(u32 i = 0; i < memory_tracker::get_tag_count(); ++i) {
+			const memory_tag_stats stats = memory_tracker::get_stats(i);
+
+			if(stats.allocation_count == 0) {
+				continue;
+			}
+
+			console::print(
+				"  {}: live {}B ({} allocations), peak {}B, {} allocations total\n",
+				stats.name,
+				stats.live_bytes,
+				stats.live_allocation_count,
+				stats.peak_bytes,
+				stats.allocation_count
+			);
+		}
+#else
+		console::print("memory tracking is disabled (define UTILITY_MEMORY_TRACKING)\n");
+#endif
+	}
+} // namespace utility
@@ -0,0 +1,202 @@
+#pragma once
+#include "utility/types.h"
+
+#ifdef UTILITY_MEMORY_TRACKING
+#include <atomic>
+#include <mutex>
+#endif
+
+namespace utility {
+	struct memory_tag_stats {
+		const char* name;
+		u64 live_bytes;
+		u64 peak_bytes;
+		u64 allocation_count;      // total number of allocations made under this tag
+		u64 live_allocation_count;
+	};
+
+#ifdef UTILITY_MEMORY_TRACKING
+	/**
+	 * \brief Records live bytes, peak bytes and allocation counts of utility::malloc/utility::free per tag.
+	 * Enabled by defining UTILITY_MEMORY_TRACKING, every allocation is then prefixed with a small header
+	 * which holds its size and tag. Tags are selected per thread with a memory_scope.
+	 */
+	class memory_tracker {
+		struct tag {
+			const char* name = nullptr;
+			std::atomic<u64> live_bytes = 0;
+			std::atomic<u64> peak_bytes = 0;
+			std::atomic<u64> allocation_count = 0;
+			std::atomic<u64> live_allocation_count = 0;
+		};
+
+		struct header {
+			u64 size;
+			u32 tag;
+		};
+
+		static_assert(sizeof(header) <= detail::tracking_header_size);
+	public:
+		static constexpr u32 max_tag_count = 64;
+
+		/**
+		 * \brief Returns the index of the tag with the specified \b name, registers the tag if necessary.
+		 */
+		[[nodiscard]] static auto get_tag(const char* name) -> u32 {
+			std::lock_guard lock(get_mutex());
+			u32 index = 0;
+
+			for(; index < get_tag_count(); ++index) {
+				if(compare_strings(get_tags()[index].name, name) == 0) {
+					return index;
+				}
+			}
+
+			// out of tags, fall back to untagged allocations
+			if(index == max_tag_count) {
+				return 0;
+			}
+
+			get_tags()[index].name = name;
+			++get_tag_count();
+
+			return index;
+		}
+
+		[[nodiscard]] static auto get_current_tag() -> u32& {
+			static thread_local u32 current_tag = 0;
+			return current_tag;
+		}
+
+		[[nodiscard]] static auto get_stats(u32 index) -> memory_tag_stats {
+			const tag& t = get_tags()[index];
+
+			return {
+				.name = t.name,
+				.live_bytes = t.live_bytes.load(std::memory_order_relaxed),
+				.peak_bytes = t.peak_bytes.load(std::memory_order_relaxed),
+				.allocation_count = t.allocation_count.load(std::memory_order_relaxed),
+				.live_allocation_count = t.live_allocation_count.load(std::memory_order_relaxed)
+			};
+		}
+
+		[[nodiscard]] static auto get_tag_count() -> u32& {
+			static u32 count = 1; // tag 0 is reserved for untagged allocations
+			return count;
+		}
+
+		static auto on_allocate(void* memory, u64 size) -> void* {
+			if(memory == nullptr) {
+				return nullptr;
+			}
+
+			const u32 index = get_current_tag();
+			new (memory) header{ size, index };
+
+			tag& t = get_tags()[index];
+			t.allocation_count.fetch_add(1, std::memory_order_relaxed);
+			t.live_allocation_count.fetch_add(1, std::memory_order_relaxed);
+			add_live_bytes(t, size);
+
+			return static_cast<u8*>(memory) + detail::tracking_header_size;
+		}
+
+		static auto on_deallocate(void* memory) -> void* {
+			if(memory == nullptr) {
+				return nullptr;
+			}
+
+			header* h = get_header(memory);
+			tag& t = get_tags()[h->tag];
+
+			t.live_allocation_count.fetch_sub(1, std::memory_order_relaxed);
+			t.live_bytes.fetch_sub(h->size, std::memory_order_relaxed);
+
+			return h;
+		}
+
+		static auto on_expand(void* memory, u64 new_size) -> bool {
+			if(memory == nullptr) {
+				return false;
+			}
+
+			header* h = get_header(memory);
+
+			if(!detail::raw_try_expand(h, new_size + detail::tracking_header_size)) {
+				return false;
+			}
+
+			tag& t = get_tags()[h->tag];
+
+			if(new_size > h->size) {
+				add_live_bytes(t, new_size - h->size);
+			}
+			else {
+				t.live_bytes.fetch_sub(h->size - new_size, std::memory_order_relaxed);
+			}
+
+			h->size = new_size;
+			return true;
+		}
+	private:
+		[[nodiscard]] static auto get_tags() -> tag* {
+			static tag tags[max_tag_count] = { { .name = "untagged" } };
+			return tags;
+		}
+
+		[[nodiscard]] static auto get_mutex() -> std::mutex& {
+			static std::mutex mutex;
+			return mutex;
+		}
+
+		[[nodiscard]] static auto get_header(void* memory) -> header* {
+			return reinterpret_cast<header*>(static_cast<u8*>(memory) - detail::tracking_header_size);
+		}
+
+		static void add_live_bytes(tag& t, u64 size) {
+			const u64 live = t.live_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+			u64 peak = t.peak_bytes.load(std::memory_order_relaxed);
+
+			while(live > peak && !t.peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+		}
+	};
+
+	/**
+	 * \brief Attributes every allocation made by the current thread during its lifetime to \b name.
+	 */
+	class memory_scope {
+	public:
+		memory_scope(const char* name) : m_previous_tag(memory_tracker::get_current_tag()) {
+			memory_tracker::get_current_tag() = memory_tracker::get_tag(name);
+		}
+
+		~memory_scope() {
+			memory_tracker::get_current_tag() = m_previous_tag;
+		}
+	private:
+		u32 m_previous_tag;
+	};
+
+	namespace detail {
+		[[nodiscard]] inline auto track_allocation(void* data, u64 size) -> void* {
+			return memory_tracker::on_allocate(data, size);
+		}
+
+		[[nodiscard]] inline auto track_deallocation(void* data) -> void* {
+			return memory_tracker::on_deallocate(data);
+		}
+
+		[[nodiscard]] inline auto track_expansion(void* data, u64 new_size) -> bool {
+			return memory_tracker::on_expand(data, new_size);
+		}
+	} // namespace detail
+#else
+	// memory tracking is disabled, scopes compile down to nothing
+	class memory_scope {
+	public:
+		memory_scope(const char* name) {
+			SUPPRESS_C4100(name);
+		}
+	};
+#endif
+} // namespace utility
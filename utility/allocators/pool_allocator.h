@@ -0,0 +1,168 @@
+#pragma once
+#include "utility/allocators/allocator_base.h"
+
+namespace utility {
+	/**
+	 * \brief Fixed-size object pool. Memory is carved out of large chunks, freed objects are kept in an
+	 * intrusive free list, which makes both allocation and deallocation O(1).
+	 * \tparam value Type of the pooled objects
+	 */
+	template<typename value>
+	class pool_allocator : public allocator_base {
+		union slot {
+			slot* next;
+			alignas(value) u8 storage[sizeof(value)];
+		};
+
+		static_assert(alignof(slot) <= alignof(std::max_align_t), "over-aligned types are not supported by the pool allocator");
+
+		struct chunk {
+			chunk(slot* slots) : slots(slots) {}
+			~chunk() {
+				utility::free(slots);
+			}
+
+			slot* slots;
+			chunk* next = nullptr;
+		};
+	public:
+		using element_type = value;
+
+		/**
+		 * \brief Creates a new pool allocator.
+		 * \param chunk_capacity Number of objects each chunk can hold
+		 */
+		pool_allocator(u64 chunk_capacity) : m_chunk_capacity(max(chunk_capacity, u64{ 1 })) {}
+
+		pool_allocator(const pool_allocator& other) = delete;
+		pool_allocator(pool_allocator&& other) noexcept {
+			*this = move(other);
+		}
+
+		pool_allocator& operator=(const pool_allocator& other) = delete;
+		pool_allocator& operator=(pool_allocator&& other) noexcept {
+			if(&other != this) {
+				free_chunks();
+
+				m_first_chunk = exchange(other.m_first_chunk, nullptr);
+				m_current_chunk = exchange(other.m_current_chunk, nullptr);
+				m_free_list = exchange(other.m_free_list, nullptr);
+				m_chunk_position = exchange(other.m_chunk_position, 0);
+				m_chunk_capacity = other.m_chunk_capacity;
+			}
+
+			return *this;
+		}
+
+		~pool_allocator() {
+			free_chunks();
+		}
+
+		/**
+		 * \brief Allocates uninitialized storage for a single object.
+		 */
+		[[nodiscard]] auto allocate() -> element_type* {
+			// reuse a previously freed slot
+			if(m_free_list) {
+				slot* s = m_free_list;
+				m_free_list = s->next;
+				return reinterpret_cast<element_type*>(s);
+			}
+
+			// carve a new slot out of the current chunk
+			if(m_current_chunk == nullptr || m_chunk_position == m_chunk_capacity) {
+				allocate_chunk();
+			}
+
+			return reinterpret_cast<element_type*>(m_current_chunk->slots + m_chunk_position++);
+		}
+
+		/**
+		 * \brief Returns the storage of a single object back to the pool, does not invoke the destructor.
+		 * \param memory Memory previously returned by allocate()
+		 */
+		void deallocate(element_type* memory) {
+			if(memory == nullptr) {
+				return;
+			}
+
+			slot* s = reinterpret_cast<slot*>(memory);
+			s->next = m_free_list;
+			m_free_list = s;
+		}
+
+		template<typename... value_types>
+		[[nodiscard]] auto emplace(value_types&&... values) -> element_type* {
+			return new (allocate()) element_type(forward<value_types>(values)...);
+		}
+
+		/**
+		 * \brief Destroys and deallocates an object created via emplace().
+		 */
+		void destroy(element_type* memory) {
+			if(memory == nullptr) {
+				return;
+			}
+
+			destroy_at(memory);
+			deallocate(memory);
+		}
+
+		/**
+		 * \brief Marks every slot as free without returning memory to the system. Destructors of live
+		 * objects aren't invoked.
+		 */
+		void reset() {
+			m_current_chunk = m_first_chunk;
+			m_chunk_position = 0;
+			m_free_list = nullptr;
+		}
+
+		[[nodiscard]] auto get_chunk_capacity() const -> u64 {
+			return m_chunk_capacity;
+		}
+	protected:
+		void allocate_chunk() {
+			m_chunk_position = 0;
+
+			// reuse chunks which were released by a reset
+			if(m_current_chunk && m_current_chunk->next) {
+				m_current_chunk = m_current_chunk->next;
+				return;
+			}
+
+			const auto memory = static_cast<slot*>(utility::malloc(m_chunk_capacity * sizeof(slot)));
+			ASSERT(memory, "allocation failure\n");
+
+			const auto new_chunk = new chunk(memory);
+
+			if(m_current_chunk) {
+				m_current_chunk->next = new_chunk;
+			}
+			else {
+				m_first_chunk = new_chunk;
+			}
+
+			m_current_chunk = new_chunk;
+		}
+
+		void free_chunks() {
+			while(m_first_chunk) {
+				chunk* temp = m_first_chunk;
+				m_first_chunk = m_first_chunk->next;
+				delete temp;
+			}
+
+			m_current_chunk = nullptr;
+			m_free_list = nullptr;
+			m_chunk_position = 0;
+		}
+	protected:
+		chunk* m_first_chunk = nullptr;
+		chunk* m_current_chunk = nullptr;
+		slot* m_free_list = nullptr;
+
+		u64 m_chunk_position = 0; // index of the next untouched slot in the current chunk
+		u64 m_chunk_capacity = 0;
+	};
+} // namespace utility
@@ -0,0 +1,275 @@
+#pragma once
+#include "utility/types.h"
+
+#include <bit>
+#include <mutex>
+
+namespace utility {
+	/**
+	 * \brief General-purpose size-class allocator. Small allocations are served from 64KB slabs, each of
+	 * which holds objects of a single size class, through thread-local free lists. Allocations larger than
+	 * the biggest size class are forwarded to the system. Defining UTILITY_SLAB_ALLOCATOR routes
+	 * utility::malloc/utility::free through this allocator.
+	 *
+	 * Every slab (and every large allocation) starts with a header at a slab-aligned address, which lets
+	 * deallocate() find the size class of any pointer by masking off its low bits. Slabs are never
+	 * returned to the system, free lists of exiting threads are handed over to a global pool.
+	 */
+	class slab_allocator {
+		static constexpr u64 slab_size = 64 * 1024;
+		static constexpr u64 header_size = 64; // keeps objects aligned to at least 16 bytes
+		static constexpr u64 max_small_size = 8192;
+		static constexpr u32 class_count = 32;
+		static constexpr u32 large_class = limits<u32>::max();
+
+		struct header {
+			u32 size_class;
+			u64 capacity; // usable bytes of a large allocation
+		};
+
+		struct free_node {
+			free_node* next;
+		};
+
+		// trivially destructible so that it stays accessible during thread and static destruction
+		struct thread_cache {
+			free_node* free_lists[class_count];
+			u8* positions[class_count];
+			u8* ends[class_count];
+			bool is_released;
+		};
+
+		struct thread_cache_guard {
+			~thread_cache_guard() {
+				release_thread_cache();
+			}
+		};
+
+		struct global_pool {
+			std::mutex mutex;
+			free_node* free_lists[class_count] = {};
+		};
+	public:
+		[[nodiscard]] static auto allocate(u64 size) -> void* {
+			if(size > max_small_size) {
+				return allocate_large(size);
+			}
+
+			const u32 size_class = get_size_class(size);
+			thread_cache& cache = get_thread_cache();
+
+			if(cache.is_released) {
+				return allocate_from_pool(size_class);
+			}
+
+			// reuse a freed object
+			if(free_node* node = cache.free_lists[size_class]) {
+				cache.free_lists[size_class] = node->next;
+				return node;
+			}
+
+			// carve a new object out of the current slab
+			const u64 class_size = get_class_size(size_class);
+
+			if(cache.positions[size_class] == nullptr || cache.positions[size_class] + class_size > cache.ends[size_class]) {
+				// take over objects freed by threads which have exited
+				if(free_node* node = take_pool_list(size_class)) {
+					cache.free_lists[size_class] = node->next;
+					return node;
+				}
+
+				u8* slab = allocate_slab(size_class);
+				cache.positions[size_class] = slab + header_size;
+				cache.ends[size_class] = slab + slab_size;
+			}
+
+			void* memory = cache.positions[size_class];
+			cache.positions[size_class] += class_size;
+			return memory;
+		}
+
+		static void deallocate(void* memory) {
+			if(memory == nullptr) {
+				return;
+			}
+
+			const header* h = get_header(memory);
+
+			if(h->size_class == large_class) {
+				free_aligned(const_cast<header*>(h));
+				return;
+			}
+
+			thread_cache& cache = get_thread_cache();
+			free_node* node = static_cast<free_node*>(memory);
+
+			if(cache.is_released) {
+				std::lock_guard lock(get_global_pool().mutex);
+				node->next = get_global_pool().free_lists[h->size_class];
+				get_global_pool().free_lists[h->size_class] = node;
+				return;
+			}
+
+			node->next = cache.free_lists[h->size_class];
+			cache.free_lists[h->size_class] = node;
+		}
+
+		/**
+		 * \brief Checks whether \b memory can hold \b new_size bytes without being moved, which is the case
+		 * whenever the new size doesn't exceed the size class (or the capacity of a large allocation).
+		 */
+		[[nodiscard]] static auto try_expand(void* memory, u64 new_size) -> bool {
+			if(memory == nullptr) {
+				return false;
+			}
+
+			const header* h = get_header(memory);
+
+			if(h->size_class == large_class) {
+				return new_size <= h->capacity;
+			}
+
+			return new_size <= get_class_size(h->size_class);
+		}
+
+		/**
+		 * \brief Returns the index of the smallest size class which can hold \b size bytes. Classes are
+		 * multiples of 16 up to 128B, after which every power of two is split into 4 classes.
+		 */
+		[[nodiscard]] static constexpr auto get_size_class(u64 size) -> u32 {
+			if(size <= 128) {
+				return size == 0 ? 0 : static_cast<u32>((size - 1) / 16);
+			}
+
+			const u32 log = static_cast<u32>(std::bit_width(size - 1)) - 1;
+			const u64 step = (u64{ 1 } << log) / 4;
+			const u64 sub = ((size - 1) - (u64{ 1 } << log)) / step;
+
+			return 8 + (log - 7) * 4 + static_cast<u32>(sub);
+		}
+
+		[[nodiscard]] static constexpr auto get_class_size(u32 size_class) -> u64 {
+			if(size_class < 8) {
+				return (size_class + 1) * 16;
+			}
+
+			const u32 log = (size_class - 8) / 4 + 7;
+			const u64 step = (u64{ 1 } << log) / 4;
+
+			return (u64{ 1 } << log) + ((size_class - 8) % 4 + 1) * step;
+		}
+	private:
+		[[nodiscard]] static auto get_thread_cache() -> thread_cache& {
+			static thread_local thread_cache cache;
+			static thread_local thread_cache_guard guard;
+			SUPPRESS_C4100(guard);
+			return cache;
+		}
+
+		[[nodiscard]] static auto get_global_pool() -> global_pool& {
+			static global_pool pool;
+			return pool;
+		}
+
+		[[nodiscard]] static auto get_header(void* memory) -> const header* {
+			return reinterpret_cast<const header*>(reinterpret_cast<u64>(memory) & ~(slab_size - 1));
+		}
+
+		static void release_thread_cache() {
+			thread_cache& cache = get_thread_cache();
+			global_pool& pool = get_global_pool();
+			std::lock_guard lock(pool.mutex);
+
+			for(u32 i = 0; i < class_count; ++i) {
+				while(free_node* node = cache.free_lists[i]) {
+					cache.free_lists[i] = node->next;
+					node->next = pool.free_lists[i];
+					pool.free_lists[i] = node;
+				}
+			}
+
+			cache.is_released = true;
+		}
+
+		[[nodiscard]] static auto take_pool_list(u32 size_class) -> free_node* {
+			global_pool& pool = get_global_pool();
+			std::lock_guard lock(pool.mutex);
+			return exchange(pool.free_lists[size_class], nullptr);
+		}
+
+		[[nodiscard]] static auto allocate_from_pool(u32 size_class) -> void* {
+			{
+				global_pool& pool = get_global_pool();
+				std::lock_guard lock(pool.mutex);
+
+				if(free_node* node = pool.free_lists[size_class]) {
+					pool.free_lists[size_class] = node->next;
+					return node;
+				}
+			}
+
+			// the calling thread is shutting down and no longer has a cache, carve a new slab directly into
+			// the global pool
+			u8* slab = allocate_slab(size_class);
+			const u64 class_size = get_class_size(size_class);
+			global_pool& pool = get_global_pool();
+			std::lock_guard lock(pool.mutex);
+
+			for(u8* object = slab + header_size + class_size; object + class_size <= slab + slab_size; object += class_size) {
+				free_node* node = reinterpret_cast<free_node*>(object);
+				node->next = pool.free_lists[size_class];
+				pool.free_lists[size_class] = node;
+			}
+
+			return slab + header_size;
+		}
+
+		[[nodiscard]] static auto allocate_slab(u32 size_class) -> u8* {
+			const auto slab = static_cast<u8*>(allocate_aligned(slab_size));
+			new (slab) header{ size_class, 0 };
+			return slab;
+		}
+
+		[[nodiscard]] static auto allocate_large(u64 size) -> void* {
+			const u64 total_size = (size + header_size + slab_size - 1) & ~(slab_size - 1);
+			const auto memory = static_cast<u8*>(allocate_aligned(total_size));
+
+			if(memory == nullptr) {
+				return nullptr;
+			}
+
+			new (memory) header{ large_class, total_size - header_size };
+			return memory + header_size;
+		}
+
+		[[nodiscard]] static auto allocate_aligned(u64 size) -> void* {
+#ifdef _WIN32
+			return _aligned_malloc(size, slab_size);
+#else
+			return std::aligned_alloc(slab_size, size);
+#endif
+		}
+
+		static void free_aligned(void* memory) {
+#ifdef _WIN32
+			_aligned_free(memory);
+#else
+			std::free(memory);
+#endif
+		}
+	};
+
+	namespace detail {
+		[[nodiscard]] inline auto slab_malloc(u64 size) -> void* {
+			return slab_allocator::allocate(size);
+		}
+
+		inline void slab_free(void* data) {
+			slab_allocator::deallocate(data);
+		}
+
+		[[nodiscard]] inline auto slab_try_expand(void* data, u64 new_size) -> bool {
+			return slab_allocator::try_expand(data, new_size);
+		}
+	} // namespace detail
+} // namespace utility
@@ -0,0 +1,304 @@
+#pragma once
+#include "utility/allocators/allocator_base.h"
+
+#ifdef SYSTEM_LINUX
+#include <sys/mman.h>
+#endif
+
+namespace utility {
+	/**
+	 * \brief Bump allocator backed by a single reserved range of virtual memory. Pages are committed lazily
+	 * as the bump pointer advances and physical memory is returned to the system when a safepoint is
+	 * restored or the allocator is cleared. Exposes the same safepoint interface as the block allocator.
+	 */
+	class virtual_allocator : public allocator_base {
+	public:
+		class safepoint {
+		public:
+			safepoint() : m_position(0) {}
+			safepoint(u64 position) : m_position(position) {}
+
+			[[nodiscard]] auto get_position() const -> u64 {
+				return m_position;
+			}
+		protected:
+			u64 m_position;
+		};
+
+		/**
+		 * \brief Reserves (but doesn't commit) a range of virtual memory.
+		 * \param reserve_size Size of the reserved range, allocations can never exceed it
+		 * \param use_huge_pages Hint the system to back the range with huge pages (Linux only)
+		 */
+		virtual_allocator(u64 reserve_size, bool use_huge_pages = false)
+			: m_commit_granularity(use_huge_pages ? huge_page_size : default_commit_granularity) {
+			m_reserved = align_up(reserve_size, m_commit_granularity);
+			m_base = reserve_aligned();
+
+#if defined(SYSTEM_LINUX) && defined(MADV_HUGEPAGE)
+			if(m_base && use_huge_pages) {
+				madvise(m_base, m_reserved, MADV_HUGEPAGE);
+			}
+#endif
+
+			ASSERT(m_base, "failed to reserve virtual memory\n");
+		}
+
+		virtual_allocator(const virtual_allocator& other) = delete;
+		virtual_allocator(virtual_allocator&& other) noexcept {
+			*this = move(other);
+		}
+
+		virtual_allocator& operator=(const virtual_allocator& other) = delete;
+		virtual_allocator& operator=(virtual_allocator&& other) noexcept {
+			if(&other != this) {
+				release();
+
+				m_base = exchange(other.m_base, nullptr);
+				m_position = exchange(other.m_position, 0);
+				m_touched = exchange(other.m_touched, 0);
+				m_committed = exchange(other.m_committed, 0);
+				m_reserved = exchange(other.m_reserved, 0);
+				m_commit_granularity = other.m_commit_granularity;
+			}
+
+			return *this;
+		}
+
+		~virtual_allocator() {
+			release();
+		}
+
+		/**
+		 * \brief Resets the bump pointer and returns all physical memory to the system, the virtual
+		 * range stays reserved.
+		 */
+		void clear() {
+			m_position = 0;
+			release_pages();
+		}
+
+		/**
+		 * \brief Allocates \b size bytes aligned to \b alignment, commits additional pages if necessary.
+		 * \param size Size of the allocation in bytes
+		 * \param alignment Alignment of the allocation, has to be a power of two which doesn't exceed the
+		 * commit granularity (64KB, 2MB with huge pages)
+		 * \return Pointer to the beginning of the allocated memory, nullptr if the reserved range is exhausted.
+		 */
+		[[nodiscard]] auto allocate(u64 size, u64 alignment = 1) -> void* {
+			ASSERT(alignment != 0 && (alignment & (alignment - 1)) == 0, "alignment has to be a power of two\n");
+			ASSERT(alignment <= m_commit_granularity, "alignment exceeds the commit granularity\n");
+
+			if(size == 0) {
+				return nullptr;
+			}
+
+			// the base address is aligned to the commit granularity, so aligning the offset aligns the address
+			const u64 position = align_up(m_position, alignment);
+
+			if(position + size > m_committed && !commit(position + size)) {
+				return nullptr;
+			}
+
+			m_position = position + size;
+			m_touched = max(m_touched, m_position);
+
+			return m_base + position;
+		}
+
+		/**
+		 * \brief Releases an allocation. Memory is only reclaimed if \b memory is the most recent allocation.
+		 */
+		void deallocate(void* memory, u64 size) {
+			if(memory != nullptr && static_cast<u8*>(memory) + size == m_base + m_position) {
+				m_position -= size;
+			}
+		}
+
+		/**
+		 * \brief Attempts to grow the most recent allocation in place.
+		 * \return True if the allocation was expanded, false otherwise.
+		 */
+		[[nodiscard]] auto try_expand(void* memory, u64 size, u64 new_size) -> bool {
+			if(memory == nullptr || static_cast<u8*>(memory) + size != m_base + m_position) {
+				return false;
+			}
+
+			const u64 start = static_cast<u8*>(memory) - m_base;
+
+			if(start + new_size > m_committed && !commit(start + new_size)) {
+				return false;
+			}
+
+			m_position = start + new_size;
+			m_touched = max(m_touched, m_position);
+
+			return true;
+		}
+
+		template<typename type>
+		[[nodiscard]] auto allocate_array(u64 count) -> type* {
+			return static_cast<type*>(allocate(sizeof(type) * count, alignof(type)));
+		}
+
+		template<typename type, typename... value_types>
+		[[nodiscard]] auto emplace(value_types&&... values) -> type* {
+			return new (allocate(sizeof(type), alignof(type))) type(forward<value_types>(values)...);
+		}
+
+		template<typename type, typename... value_types>
+		[[nodiscard]] auto emplace_array(u64 count, const value_types&... values) -> type* {
+			type* memory = allocate_array<type>(count);
+
+			for(u64 i = 0; i < count; ++i) {
+				new (memory + i) type(values...);
+			}
+
+			return memory;
+		}
+
+		auto create_safepoint() const -> safepoint {
+			return { m_position };
+		}
+
+		void restore_safepoint(const safepoint& safepoint) {
+			m_position = safepoint.get_position();
+			release_pages();
+		}
+
+		[[nodiscard]] auto get_used_bytes() const -> u64 {
+			return m_position;
+		}
+
+		[[nodiscard]] auto get_committed_bytes() const -> u64 {
+			return m_committed;
+		}
+
+		[[nodiscard]] auto get_reserved_bytes() const -> u64 {
+			return m_reserved;
+		}
+	protected:
+		[[nodiscard]] static constexpr auto align_up(u64 value, u64 alignment) -> u64 {
+			return (value + alignment - 1) & ~(alignment - 1);
+		}
+
+		// the system only aligns reservations to a page (64KB on windows), huge pages can only back 2MB
+		// regions which are aligned to 2MB, the base is therefore aligned to the commit granularity
+		[[nodiscard]] auto reserve_aligned() const -> u8* {
+#ifdef SYSTEM_WINDOWS
+			if(void* memory = VirtualAlloc(nullptr, m_reserved, MEM_RESERVE, PAGE_NOACCESS)) {
+				if(reinterpret_cast<u64>(memory) % m_commit_granularity == 0) {
+					return static_cast<u8*>(memory);
+				}
+
+				VirtualFree(memory, 0, MEM_RELEASE);
+			}
+
+			// parts of a reservation can't be released, find an aligned address in a larger reservation and
+			// reserve exactly that range, another thread can grab it in between, hence the retries
+			for(u32 attempt = 0; attempt < 8; ++attempt) {
+				void* probe = VirtualAlloc(nullptr, m_reserved + m_commit_granularity, MEM_RESERVE, PAGE_NOACCESS);
+
+				if(probe == nullptr) {
+					return nullptr;
+				}
+
+				VirtualFree(probe, 0, MEM_RELEASE);
+
+				void* aligned = reinterpret_cast<void*>(align_up(reinterpret_cast<u64>(probe), m_commit_granularity));
+
+				if(void* memory = VirtualAlloc(aligned, m_reserved, MEM_RESERVE, PAGE_NOACCESS)) {
+					return static_cast<u8*>(memory);
+				}
+			}
+
+			return nullptr;
+#else
+			// over-reserve by one granule and unmap the slack on both sides of the aligned range
+			const u64 size = m_reserved + m_commit_granularity;
+			void* memory = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+			if(memory == MAP_FAILED) {
+				return nullptr;
+			}
+
+			u8* start = static_cast<u8*>(memory);
+			u8* base = reinterpret_cast<u8*>(align_up(reinterpret_cast<u64>(start), m_commit_granularity));
+
+			if(base != start) {
+				munmap(start, base - start);
+			}
+
+			munmap(base + m_reserved, start + size - (base + m_reserved));
+			return base;
+#endif
+		}
+
+		auto commit(u64 end) -> bool {
+			if(end > m_reserved) {
+				ASSERT(false, "virtual allocator ran out of reserved memory\n");
+				return false;
+			}
+
+			const u64 new_committed = min(align_up(end, m_commit_granularity), m_reserved);
+
+#ifdef SYSTEM_WINDOWS
+			if(!VirtualAlloc(m_base + m_committed, new_committed - m_committed, MEM_COMMIT, PAGE_READWRITE)) {
+				return false;
+			}
+#else
+			if(mprotect(m_base + m_committed, new_committed - m_committed, PROT_READ | PROT_WRITE) != 0) {
+				return false;
+			}
+#endif
+
+			m_committed = new_committed;
+			return true;
+		}
+
+		void release_pages() {
+			// keep the granule the bump pointer is in, this way repeatedly restoring a safepoint within
+			// the same granule doesn't incur any system calls
+			const u64 start = align_up(m_position, m_commit_granularity);
+
+			if(m_touched <= start) {
+				return;
+			}
+
+#ifdef SYSTEM_WINDOWS
+			VirtualFree(m_base + start, m_committed - start, MEM_DECOMMIT);
+			m_committed = start;
+#else
+			// the pages stay accessible and get zero-filled on the next access
+			madvise(m_base + start, m_committed - start, MADV_DONTNEED);
+#endif
+
+			m_touched = start;
+		}
+
+		void release() {
+			if(m_base == nullptr) {
+				return;
+			}
+
+#ifdef SYSTEM_WINDOWS
+			VirtualFree(m_base, 0, MEM_RELEASE);
+#else
+			munmap(m_base, m_reserved);
+#endif
+
+			m_base = nullptr;
+		}
+	protected:
+		static constexpr u64 default_commit_granularity = 64 * 1024;
+		static constexpr u64 huge_page_size = 2 * 1024 * 1024;
+
+		u8* m_base = nullptr;
+		u64 m_position = 0;  // offset of the bump pointer
+		u64 m_touched = 0;   // end of the memory touched since pages were last released
+		u64 m_committed = 0; // size of the accessible range
+		u64 m_reserved = 0;  // size of the reserved range
+
+		u64 m_commit_granularity = default_commit_granularity;
+	};
+} // namespace utility
@@ -0,0 +1,810 @@
+#pragma once
+#include "utility/containers/map.h"
+
+namespace utility {
+	namespace detail {
+		template<typename compare>
+		concept transparent_compare = requires {
+			typename compare::is_transparent;
+		};
+	} // namespace detail
+
+	/**
+	 * \brief Ordered map implemented as a B+tree. Nodes are a few cache lines wide, values are only stored
+	 * in the leaves, which are linked together so that iteration and range scans walk memory linearly.
+	 * Arithmetic keys are searched with a branchless linear scan (which the compiler vectorizes), other
+	 * keys with a binary search. Erasing never rebalances, leaves are released once they become empty.
+	 * \tparam key Type to use as a key type
+	 * \tparam value Type to use as the value type, void turns the map into a set
+	 * \tparam compare Strict weak ordering of the keys, lookups are transparent if it declares is_transparent
+	 * \tparam alloc Allocator used for the nodes
+	 */
+	template<
+		typename key,
+		typename value,
+		typename compare = std::less<>,
+		allocator alloc = heap_allocator
+	>
+	class btree_map {
+	public:
+		using bucket_type = typename std::conditional_t<is_map_v<value>, std::pair<key, value>, key>;
+		using element_type = value;
+		using key_type = key;
+		using allocator_type = alloc;
+	protected:
+		static constexpr u64 node_size = 256; // four cache lines
+		static constexpr u64 max_height = 32;
+
+		static constexpr u64 leaf_capacity = min(max((node_size - 24) / sizeof(bucket_type), u64{ 4 }), u64{ 255 });
+		static constexpr u64 internal_capacity = min(max((node_size - 24) / (sizeof(key) + sizeof(void*)), u64{ 4 }), u64{ 255 });
+
+		static constexpr bool linear_search = std::is_arithmetic_v<key>;
+
+		struct node {
+			u16 m_count; // number of values for leaves, number of keys for internal nodes
+			bool m_is_leaf;
+		};
+
+		struct leaf_node : node {
+			[[nodiscard]] auto get_values() -> bucket_type* {
+				return reinterpret_cast<bucket_type*>(m_storage);
+			}
+
+			leaf_node* m_next;
+			alignas(bucket_type) u8 m_storage[sizeof(bucket_type) * leaf_capacity];
+		};
+
+		// children[i] holds the keys in [keys[i - 1], keys[i])
+		struct internal_node : node {
+			[[nodiscard]] auto get_keys() -> key_type* {
+				return reinterpret_cast<key_type*>(m_storage);
+			}
+
+			node* m_children[internal_capacity + 1];
+			alignas(key_type) u8 m_storage[sizeof(key_type) * internal_capacity];
+		};
+	public:
+		template<typename type>
+		class iterator_base {
+		public:
+			iterator_base() = default;
+			iterator_base(leaf_node* leaf, u16 index) : m_leaf(leaf), m_index(index) {}
+
+			[[nodiscard]] auto operator*() const -> type& {
+				return m_leaf->get_values()[m_index];
+			}
+			[[nodiscard]] auto operator->() const -> type* {
+				return m_leaf->get_values() + m_index;
+			}
+
+			auto operator++() -> iterator_base& {
+				if(++m_index == m_leaf->m_count) {
+					m_leaf = m_leaf->m_next;
+					m_index = 0;
+				}
+
+				return *this;
+			}
+
+			[[nodiscard]] auto operator==(const iterator_base& other) const -> bool {
+				return m_leaf == other.m_leaf && m_index == other.m_index;
+			}
+			[[nodiscard]] auto operator!=(const iterator_base& other) const -> bool {
+				return !(*this == other);
+			}
+
+			operator iterator_base<const type>() const {
+				return { m_leaf, m_index };
+			}
+		private:
+			leaf_node* m_leaf = nullptr;
+			u16 m_index = 0;
+		};
+
+		using const_iterator = iterator_base<const bucket_type>;
+		using iterator = iterator_base<bucket_type>;
+
+		btree_map() = default;
+		btree_map(allocator_type& allocator) : m_allocator(allocator) {}
+		btree_map(initializer_list<bucket_type> ilist) {
+			for(const auto& i : ilist) {
+				emplace(i);
+			}
+		}
+		btree_map(const btree_map& other) : m_less(other.m_less), m_allocator(other.m_allocator) {
+			assign_sorted(other.begin(), other.end());
+		}
+		btree_map(btree_map&& other) noexcept : m_less(other.m_less), m_allocator(other.m_allocator) {
+			take(other);
+		}
+
+		~btree_map() {
+			clear();
+		}
+
+		auto operator=(const btree_map& other) -> btree_map& {
+			if(&other != this) {
+				m_less = other.m_less;
+				assign_sorted(other.begin(), other.end());
+			}
+
+			return *this;
+		}
+		auto operator=(btree_map&& other) noexcept -> btree_map& {
+			if(&other != this) {
+				clear();
+
+				m_less = other.m_less;
+				m_allocator = other.m_allocator;
+				take(other);
+			}
+
+			return *this;
+		}
+
+		/**
+		 * \brief Replaces the contents with the elements in [first, last), which have to be sorted and unique.
+		 * Leaves are filled completely and the inner levels are built bottom-up, which is much faster than
+		 * inserting the elements one by one.
+		 */
+		template<typename iterator_type>
+		void assign_sorted(iterator_type first, iterator_type last) {
+			clear();
+
+			dynamic_array<node*> level;
+			dynamic_array<const key_type*> level_keys; // smallest key of every subtree in level
+			leaf_node* leaf = nullptr;
+
+			for(; first != last; ++first) {
+				if(leaf == nullptr || leaf->m_count == leaf_capacity) {
+					leaf_node* next = allocate_leaf();
+
+					if(leaf) {
+						leaf->m_next = next;
+					}
+
+					leaf = next;
+					level.push_back(leaf);
+				}
+
+				bucket_type* slot = leaf->get_values() + leaf->m_count;
+				ASSERT(leaf->m_count == 0 || m_less(get_key(slot[-1]), get_key(*first)), "input is not sorted\n");
+
+				utility::construct_at(slot, *first);
+				++leaf->m_count;
+				++m_size;
+			}
+
+			if(level.is_empty()) {
+				return;
+			}
+
+			m_first_leaf = static_cast<leaf_node*>(level[0]);
+
+			for(node* n : level) {
+				level_keys.push_back(&get_key(static_cast<leaf_node*>(n)->get_values()[0]));
+			}
+
+			while(level.get_size() > 1) {
+				dynamic_array<node*> parents;
+				dynamic_array<const key_type*> parent_keys;
+
+				for(u64 i = 0; i < level.get_size(); i += internal_capacity + 1) {
+					internal_node* parent = allocate_internal();
+					const u64 child_count = min(level.get_size() - i, internal_capacity + 1);
+
+					for(u64 j = 0; j < child_count; ++j) {
+						parent->m_children[j] = level[i + j];
+
+						if(j > 0) {
+							utility::construct_at(parent->get_keys() + j - 1, *level_keys[i + j]);
+						}
+					}
+
+					parent->m_count = static_cast<u16>(child_count - 1);
+					parents.push_back(parent);
+					parent_keys.push_back(level_keys[i]);
+				}
+
+				level = utility::move(parents);
+				level_keys = utility::move(parent_keys);
+				++m_height;
+			}
+
+			m_root = level[0];
+		}
+
+		template <typename q = value, enable_if_t<is_map_v<q>, bool> = true>
+		auto operator[](const key_type& k) -> q& {
+			return try_emplace(k).first->second;
+		}
+
+		template <typename q = value, enable_if_t<is_map_v<q>, bool> = true>
+		[[nodiscard]] auto at(const key_type& k) const -> const q& {
+			const const_iterator it = find(k);
+			ASSERT(it != end(), "key not found\n");
+
+			return it->second;
+		}
+
+		[[nodiscard]] auto contains(const key_type& k) const -> bool {
+			return find(k) != end();
+		}
+
+		template<typename K>
+			requires detail::transparent_compare<compare>
+		[[nodiscard]] auto contains(const K& k) const -> bool {
+			return find(k) != end();
+		}
+
+		[[nodiscard]] auto find(const key_type& k) -> iterator { return do_find(k); }
+		[[nodiscard]] auto find(const key_type& k) const -> const_iterator { return do_find(k); }
+
+		template<typename K>
+			requires detail::transparent_compare<compare>
+		[[nodiscard]] auto find(const K& k) -> iterator { return do_find(k); }
+
+		template<typename K>
+			requires detail::transparent_compare<compare>
+		[[nodiscard]] auto find(const K& k) const -> const_iterator { return do_find(k); }
+
+		/**
+		 * \brief Returns an iterator to the first element whose key is not less than \b k.
+		 */
+		[[nodiscard]] auto lower_bound(const key_type& k) -> iterator { return do_lower_bound(k); }
+		[[nodiscard]] auto lower_bound(const key_type& k) const -> const_iterator { return do_lower_bound(k); }
+
+		template<typename K>
+			requires detail::transparent_compare<compare>
+		[[nodiscard]] auto lower_bound(const K& k) const -> const_iterator { return do_lower_bound(k); }
+
+		/**
+		 * \brief Returns an iterator to the first element whose key is greater than \b k.
+		 */
+		[[nodiscard]] auto upper_bound(const key_type& k) -> iterator { return do_upper_bound(k); }
+		[[nodiscard]] auto upper_bound(const key_type& k) const -> const_iterator { return do_upper_bound(k); }
+
+		template<typename K>
+			requires detail::transparent_compare<compare>
+		[[nodiscard]] auto upper_bound(const K& k) const -> const_iterator { return do_upper_bound(k); }
+
+		auto insert(const bucket_type& v) -> std::pair<iterator, bool> {
+			return emplace(v);
+		}
+
+		auto insert(bucket_type&& v) -> std::pair<iterator, bool> {
+			return emplace(utility::move(v));
+		}
+
+		template<class... Args>
+		auto emplace(Args&&... args) -> std::pair<iterator, bool> {
+			bucket_type v(utility::forward<Args>(args)...);
+
+			return do_insert(get_key(v), [&](bucket_type* slot) {
+				utility::construct_at(slot, utility::move(v));
+			});
+		}
+
+		template <typename q = value, typename... Args, enable_if_t<is_map_v<q>, bool> = true>
+		auto try_emplace(const key_type& k, Args&&... args) -> std::pair<iterator, bool> {
+			return do_insert(k, [&](bucket_type* slot) {
+				utility::construct_at(slot, std::piecewise_construct, std::forward_as_tuple(k), std::forward_as_tuple(utility::forward<Args>(args)...));
+			});
+		}
+
+		/**
+		 * \brief Removes the element with the specified key, if it exists.
+		 * \return Number of removed elements (0 or 1).
+		 */
+		auto erase(const key_type& k) -> u64 {
+			return do_erase(k);
+		}
+
+		template<typename K>
+			requires detail::transparent_compare<compare>
+		auto erase(const K& k) -> u64 {
+			return do_erase(k);
+		}
+
+		void clear() {
+			if(m_root) {
+				destroy_node(m_root);
+			}
+
+			m_root = nullptr;
+			m_first_leaf = nullptr;
+			m_size = 0;
+			m_height = 0;
+		}
+
+		[[nodiscard]] auto begin() -> iterator { return { m_first_leaf, 0 }; }
+		[[nodiscard]] auto begin() const -> const_iterator { return { m_first_leaf, 0 }; }
+		[[nodiscard]] auto end() -> iterator { return {}; }
+		[[nodiscard]] auto end() const -> const_iterator { return {}; }
+
+		[[nodiscard]] auto get_size() const -> u64 {
+			return m_size;
+		}
+		[[nodiscard]] auto is_empty() const -> bool {
+			return m_size == 0;
+		}
+		/**
+		 * \brief Returns the number of internal levels above the leaves.
+		 */
+		[[nodiscard]] auto get_height() const -> u64 {
+			return m_height;
+		}
+
+		/**
+		 * \brief Returns the number of bytes allocated for nodes.
+		 */
+		[[nodiscard]] auto get_memory_usage() const -> u64 {
+			return m_leaf_count * sizeof(leaf_node) + m_internal_count * sizeof(internal_node);
+		}
+	protected:
+		[[nodiscard]] static auto get_key(const bucket_type& vt) -> const key_type& {
+			if constexpr(is_map_v<value>) {
+				return vt.first;
+			}
+			else {
+				return vt;
+			}
+		}
+
+		// index of the first value in the leaf which isn't less than k
+		template<typename K>
+		[[nodiscard]] auto search_leaf(leaf_node* leaf, const K& k) const -> u16 {
+			const bucket_type* values = leaf->get_values();
+
+			if constexpr(linear_search) {
+				u16 index = 0;
+
+				for(u16 i = 0; i < leaf->m_count; ++i) {
+					index += m_less(get_key(values[i]), k);
+				}
+
+				return index;
+			}
+			else {
+				u16 low = 0;
+				u16 high = leaf->m_count;
+
+				while(low < high) {
+					const u16 middle = (low + high) / 2;
+
+					if(m_less(get_key(values[middle]), k)) {
+						low = middle + 1;
+					}
+					else {
+						high = middle;
+					}
+				}
+
+				return low;
+			}
+		}
+
+		// index of the child which may contain k
+		template<typename K>
+		[[nodiscard]] auto search_internal(internal_node* n, const K& k) const -> u16 {
+			const key_type* keys = n->get_keys();
+
+			if constexpr(linear_search) {
+				u16 index = 0;
+
+				for(u16 i = 0; i < n->m_count; ++i) {
+					index += !m_less(k, keys[i]);
+				}
+
+				return index;
+			}
+			else {
+				u16 low = 0;
+				u16 high = n->m_count;
+
+				while(low < high) {
+					const u16 middle = (low + high) / 2;
+
+					if(m_less(k, keys[middle])) {
+						high = middle;
+					}
+					else {
+						low = middle + 1;
+					}
+				}
+
+				return low;
+			}
+		}
+
+		template<typename K>
+		[[nodiscard]] auto find_leaf(const K& k) const -> leaf_node* {
+			node* current = m_root;
+
+			while(!current->m_is_leaf) {
+				internal_node* n = static_cast<internal_node*>(current);
+				current = n->m_children[search_internal(n, k)];
+			}
+
+			return static_cast<leaf_node*>(current);
+		}
+
+		template<typename K>
+		auto do_find(const K& k) const -> iterator {
+			if(m_root == nullptr) {
+				return {};
+			}
+
+			leaf_node* leaf = find_leaf(k);
+			const u16 index = search_leaf(leaf, k);
+
+			if(index < leaf->m_count && !m_less(k, get_key(leaf->get_values()[index]))) {
+				return { leaf, index };
+			}
+
+			return {};
+		}
+
+		template<typename K>
+		auto do_lower_bound(const K& k) const -> iterator {
+			if(m_root == nullptr) {
+				return {};
+			}
+
+			leaf_node* leaf = find_leaf(k);
+			const u16 index = search_leaf(leaf, k);
+
+			// every value in the leaf is smaller, the next leaf starts at a separator which isn't
+			return index < leaf->m_count ? iterator(leaf, index) : iterator(leaf->m_next, 0);
+		}
+
+		template<typename K>
+		auto do_upper_bound(const K& k) const -> iterator {
+			iterator it = do_lower_bound(k);
+
+			if(it != iterator() && !m_less(k, get_key(*it))) {
+				++it;
+			}
+
+			return it;
+		}
+
+		template<typename K, typename function>
+		auto do_insert(const K& k, function&& construct) -> std::pair<iterator, bool> {
+			if(m_root == nullptr) {
+				m_first_leaf = allocate_leaf();
+				m_root = m_first_leaf;
+			}
+
+			internal_node* path[max_height];
+			u16 path_index[max_height];
+			u64 depth = 0;
+			node* current = m_root;
+
+			while(!current->m_is_leaf) {
+				internal_node* n = static_cast<internal_node*>(current);
+
+				path[depth] = n;
+				path_index[depth] = search_internal(n, k);
+				current = n->m_children[path_index[depth++]];
+			}
+
+			leaf_node* leaf = static_cast<leaf_node*>(current);
+			u16 index = search_leaf(leaf, k);
+
+			if(index < leaf->m_count && !m_less(k, get_key(leaf->get_values()[index]))) {
+				return { iterator(leaf, index), false };
+			}
+
+			if(leaf->m_count == leaf_capacity) {
+				leaf_node* right = split_leaf(leaf);
+				insert_into_parent(path, path_index, depth, leaf, get_key(right->get_values()[0]), right);
+
+				if(index > leaf->m_count) {
+					index -= leaf->m_count;
+					leaf = right;
+				}
+			}
+
+			shift_right(leaf->get_values(), index, leaf->m_count);
+			construct(leaf->get_values() + index);
+
+			++leaf->m_count;
+			++m_size;
+
+			return { iterator(leaf, index), true };
+		}
+
+		// moves the upper half of the values into a new leaf which follows the split one
+		auto split_leaf(leaf_node* leaf) -> leaf_node* {
+			leaf_node* right = allocate_leaf();
+			const u16 middle = leaf->m_count / 2;
+
+			utility::relocate_range(right->get_values(), leaf->get_values() + middle, leaf->m_count - middle);
+
+			right->m_count = leaf->m_count - middle;
+			right->m_next = leaf->m_next;
+			leaf->m_count = middle;
+			leaf->m_next = right;
+
+			return right;
+		}
+
+		// links right (whose smallest key is separator) next to left, splits full ancestors on the way up
+		void insert_into_parent(internal_node** path, u16* path_index, u64 depth, node* left, key_type separator, node* right) {
+			while(depth > 0) {
+				internal_node* parent = path[--depth];
+				const u16 index = path_index[depth];
+
+				if(parent->m_count < internal_capacity) {
+					insert_internal(parent, index, utility::move(separator), right);
+					return;
+				}
+
+				// the middle key moves up, the keys and children right of it move into the sibling
+				internal_node* sibling = allocate_internal();
+				const u16 middle = parent->m_count / 2;
+				key_type* keys = parent->get_keys();
+
+				key_type middle_key = utility::move(keys[middle]);
+				utility::destroy_at(keys + middle);
+
+				utility::relocate_range(sibling->get_keys(), keys + middle + 1, parent->m_count - middle - 1);
+				utility::memcpy(sibling->m_children, parent->m_children + middle + 1, sizeof(node*) * (parent->m_count - middle));
+
+				sibling->m_count = parent->m_count - middle - 1;
+				parent->m_count = middle;
+
+				if(index <= middle) {
+					insert_internal(parent, index, utility::move(separator), right);
+				}
+				else {
+					insert_internal(sibling, index - middle - 1, utility::move(separator), right);
+				}
+
+				left = parent;
+				right = sibling;
+				separator = utility::move(middle_key);
+			}
+
+			internal_node* root = allocate_internal();
+
+			utility::construct_at(root->get_keys(), utility::move(separator));
+			root->m_children[0] = left;
+			root->m_children[1] = right;
+			root->m_count = 1;
+
+			m_root = root;
+			++m_height;
+			ASSERT(m_height < max_height, "btree height exceeded\n");
+		}
+
+		// inserts separator and the child to its right after children[index]
+		static void insert_internal(internal_node* n, u16 index, key_type&& separator, node* child) {
+			shift_right(n->get_keys(), index, n->m_count);
+			utility::memmove(n->m_children + index + 2, n->m_children + index + 1, sizeof(node*) * (n->m_count - index));
+
+			utility::construct_at(n->get_keys() + index, utility::move(separator));
+			n->m_children[index + 1] = child;
+			++n->m_count;
+		}
+
+		template<typename K>
+		auto do_erase(const K& k) -> u64 {
+			if(m_root == nullptr) {
+				return 0;
+			}
+
+			internal_node* path[max_height];
+			u16 path_index[max_height];
+			u64 depth = 0;
+			node* current = m_root;
+
+			while(!current->m_is_leaf) {
+				internal_node* n = static_cast<internal_node*>(current);
+
+				path[depth] = n;
+				path_index[depth] = search_internal(n, k);
+				current = n->m_children[path_index[depth++]];
+			}
+
+			leaf_node* leaf = static_cast<leaf_node*>(current);
+			const u16 index = search_leaf(leaf, k);
+
+			if(index == leaf->m_count || m_less(k, get_key(leaf->get_values()[index]))) {
+				return 0;
+			}
+
+			utility::destroy_at(leaf->get_values() + index);
+			shift_left(leaf->get_values(), index, leaf->m_count);
+
+			--leaf->m_count;
+			--m_size;
+
+			if(leaf->m_count == 0) {
+				remove_leaf(path, path_index, depth, leaf);
+			}
+
+			return 1;
+		}
+
+		void remove_leaf(internal_node** path, u16* path_index, u64 depth, leaf_node* leaf) {
+			// unlink the leaf, its predecessor is the rightmost leaf of the closest left subtree
+			if(leaf == m_first_leaf) {
+				m_first_leaf = leaf->m_next;
+			}
+			else {
+				u64 level = depth;
+
+				while(path_index[level - 1] == 0) {
+					--level;
+				}
+
+				node* previous = path[level - 1]->m_children[path_index[level - 1] - 1];
+
+				while(!previous->m_is_leaf) {
+					internal_node* n = static_cast<internal_node*>(previous);
+					previous = n->m_children[n->m_count];
+				}
+
+				static_cast<leaf_node*>(previous)->m_next = leaf->m_next;
+			}
+
+			deallocate_leaf(leaf);
+
+			// remove the child from its parent, parents which lose their only child are removed as well
+			while(depth > 0) {
+				internal_node* parent = path[depth - 1];
+				const u16 index = path_index[depth - 1];
+
+				if(parent->m_count > 0) {
+					const u16 key_index = index > 0 ? index - 1 : 0;
+					key_type* keys = parent->get_keys();
+
+					utility::destroy_at(keys + key_index);
+					shift_left(keys, key_index, parent->m_count);
+					utility::memmove(parent->m_children + index, parent->m_children + index + 1, sizeof(node*) * (parent->m_count - index));
+
+					--parent->m_count;
+					break;
+				}
+
+				deallocate_internal(parent);
+				--depth;
+			}
+
+			if(depth == 0) {
+				// the root itself was removed
+				m_root = nullptr;
+				m_first_leaf = nullptr;
+				m_height = 0;
+				return;
+			}
+
+			// shrink the tree while the root only has a single child
+			while(!m_root->m_is_leaf && m_root->m_count == 0) {
+				internal_node* root = static_cast<internal_node*>(m_root);
+
+				m_root = root->m_children[0];
+				deallocate_internal(root);
+				--m_height;
+			}
+		}
+
+		// moves [index, count) one slot to the right
+		template<typename type>
+		static void shift_right(type* data, u64 index, u64 count) {
+			if constexpr(is_trivially_relocatable_v<type>) {
+				utility::memmove(data + index + 1, data + index, (count - index) * sizeof(type));
+			}
+			else {
+				for(u64 i = count; i > index; --i) {
+					utility::construct_at(data + i, utility::move(data[i - 1]));
+					utility::destroy_at(data + i - 1);
+				}
+			}
+		}
+
+		// moves (index, count) one slot to the left, the element at index has to be destroyed already
+		template<typename type>
+		static void shift_left(type* data, u64 index, u64 count) {
+			if constexpr(is_trivially_relocatable_v<type>) {
+				utility::memmove(data + index, data + index + 1, (count - index - 1) * sizeof(type));
+			}
+			else {
+				for(u64 i = index + 1; i < count; ++i) {
+					utility::construct_at(data + i - 1, utility::move(data[i]));
+					utility::destroy_at(data + i);
+				}
+			}
+		}
+
+		auto allocate_leaf() -> leaf_node* {
+			leaf_node* leaf = static_cast<leaf_node*>(m_allocator.get().allocate(sizeof(leaf_node), alignof(leaf_node)));
+			ASSERT(leaf, "allocation failure\n");
+
+			leaf->m_count = 0;
+			leaf->m_is_leaf = true;
+			leaf->m_next = nullptr;
+			++m_leaf_count;
+
+			return leaf;
+		}
+
+		auto allocate_internal() -> internal_node* {
+			internal_node* n = static_cast<internal_node*>(m_allocator.get().allocate(sizeof(internal_node), alignof(internal_node)));
+			ASSERT(n, "allocation failure\n");
+
+			n->m_count = 0;
+			n->m_is_leaf = false;
+			++m_internal_count;
+
+			return n;
+		}
+
+		void deallocate_leaf(leaf_node* leaf) {
+			m_allocator.get().deallocate(leaf, sizeof(leaf_node));
+			--m_leaf_count;
+		}
+
+		void deallocate_internal(internal_node* n) {
+			m_allocator.get().deallocate(n, sizeof(internal_node));
+			--m_internal_count;
+		}
+
+		void destroy_node(node* n) {
+			if(n->m_is_leaf) {
+				leaf_node* leaf = static_cast<leaf_node*>(n);
+
+				if constexpr(!is_trivial_v<bucket_type>) {
+					utility::destruct_range(leaf->get_values(), leaf->get_values() + leaf->m_count);
+				}
+
+				deallocate_leaf(leaf);
+				return;
+			}
+
+			internal_node* internal = static_cast<internal_node*>(n);
+
+			for(u16 i = 0; i <= internal->m_count; ++i) {
+				destroy_node(internal->m_children[i]);
+			}
+
+			if constexpr(!is_trivial_v<key_type>) {
+				utility::destruct_range(internal->get_keys(), internal->get_keys() + internal->m_count);
+			}
+
+			deallocate_internal(internal);
+		}
+
+		void take(btree_map& other) {
+			m_root = exchange(other.m_root, nullptr);
+			m_first_leaf = exchange(other.m_first_leaf, nullptr);
+			m_size = exchange(other.m_size, 0);
+			m_height = exchange(other.m_height, 0);
+			m_leaf_count = exchange(other.m_leaf_count, 0);
+			m_internal_count = exchange(other.m_internal_count, 0);
+		}
+	protected:
+		node* m_root = nullptr;
+		leaf_node* m_first_leaf = nullptr;
+
+		u64 m_size = 0;
+		u64 m_height = 0;
+		u64 m_leaf_count = 0;
+		u64 m_internal_count = 0;
+
+		[[no_unique_address]] compare m_less;
+		[[no_unique_address]] detail::allocator_reference<allocator_type> m_allocator;
+	};
+
+	template<
+		typename key,
+		typename compare = std::less<>,
+		allocator alloc = heap_allocator
+	>
+	using btree_set = btree_map<key, void, compare, alloc>;
+
+	template<typename k, typename v, typename c, typename a>
+	struct is_trivially_relocatable<btree_map<k, v, c, a>> : true_type {};
+} // namespace utility
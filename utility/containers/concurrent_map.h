@@ -0,0 +1,309 @@
+#pragma once
+#include "utility/containers/map.h"
+
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <thread>
+
+namespace utility {
+	/**
+	 * \brief Thread-safe hash map. Keys are partitioned into \b shard_count independent maps, each of which
+	 * is guarded by its own reader-writer lock, threads only contend when they touch the same shard.
+	 * Lookups take a shared lock, modifications an exclusive one. Since references into a shard would be
+	 * invalidated by concurrent modifications, values are either returned by copy or accessed through a
+	 * callback which runs while the lock is held.
+	 * \tparam key Type to use as a key type
+	 * \tparam value Type to use as the value type
+	 * \tparam shard_count Number of shards, has to be a power of two
+	 * \tparam hash Hash to use when hashing the key type, the shard is selected by bits of the remixed hash
+	 * which the shards' maps don't use
+	 * \tparam key_equal Key equality operator, lookups are transparent if both functors are
+	 * \tparam alloc Allocator used by the shards, has to be thread-safe
+	 */
+	template<
+		typename key,
+		typename value,
+		u64 shard_count = 64,
+		typename hash = hash<key>,
+		typename key_equal = std::equal_to<>,
+		allocator alloc = heap_allocator
+	>
+	class concurrent_map {
+		static_assert(is_map_v<value>, "concurrent maps need a value type");
+		static_assert(shard_count > 0 && (shard_count & (shard_count - 1)) == 0, "shard count has to be a power of two");
+
+		static constexpr u64 shard_bit_offset = 8; // skip the fingerprint byte
+	public:
+		using map_type = map<key, value, hash, key_equal, alloc>;
+		using bucket_type = typename map_type::bucket_type;
+
+		using element_type = value;
+		using key_type = key;
+		using allocator_type = alloc;
+
+		concurrent_map() = default;
+		concurrent_map(u64 capacity) {
+			reserve(capacity);
+		}
+		concurrent_map(allocator_type& allocator)
+			: concurrent_map(allocator, std::make_index_sequence<shard_count>{}) {}
+		concurrent_map(u64 capacity, allocator_type& allocator)
+			: concurrent_map(allocator) {
+			reserve(capacity);
+		}
+
+		concurrent_map(const concurrent_map& other) = delete;
+		concurrent_map& operator=(const concurrent_map& other) = delete;
+
+		/**
+		 * \brief Returns a copy of the value associated with \b k, if it exists.
+		 */
+		[[nodiscard]] auto find(const key_type& k) const -> std::optional<element_type> {
+			return do_find(k);
+		}
+
+		template<typename K>
+			requires detail::transparent_lookup<hash, key_equal>
+		[[nodiscard]] auto find(const K& k) const -> std::optional<element_type> {
+			return do_find(k);
+		}
+
+		[[nodiscard]] auto contains(const key_type& k) const -> bool {
+			return do_contains(k);
+		}
+
+		template<typename K>
+			requires detail::transparent_lookup<hash, key_equal>
+		[[nodiscard]] auto contains(const K& k) const -> bool {
+			return do_contains(k);
+		}
+
+		/**
+		 * \brief Constructs a value from \b args under \b k, an existing value is left untouched.
+		 * \return True if the value was inserted, false if the key already existed.
+		 */
+		template<typename... Args>
+		auto insert(const key_type& k, Args&&... args) -> bool {
+			shard& s = get_shard(k);
+			std::unique_lock lock(s.mutex);
+
+			return s.data.try_emplace(k, utility::forward<Args>(args)...).second;
+		}
+
+		/**
+		 * \brief Inserts \b v under \b k, an existing value is overwritten.
+		 * \return True if the value was inserted, false if an existing value was assigned.
+		 */
+		auto insert_or_assign(const key_type& k, const element_type& v) -> bool {
+			shard& s = get_shard(k);
+			std::unique_lock lock(s.mutex);
+
+			auto [it, inserted] = s.data.try_emplace(k, v);
+
+			if(!inserted) {
+				it->second = v;
+			}
+
+			return inserted;
+		}
+
+		/**
+		 * \brief Invokes \b func with a mutable reference to the value associated with \b k. The shard stays
+		 * locked while \b func runs, which makes read-modify-write sequences atomic.
+		 * \return True if the key exists, false otherwise.
+		 */
+		template<typename function>
+		auto update(const key_type& k, function&& func) -> bool {
+			return do_update(k, func);
+		}
+
+		template<typename K, typename function>
+			requires detail::transparent_lookup<hash, key_equal>
+		auto update(const K& k, function&& func) -> bool {
+			return do_update(k, func);
+		}
+
+		/**
+		 * \brief Removes the element with the specified key, if it exists.
+		 * \return Number of removed elements (0 or 1).
+		 */
+		auto erase(const key_type& k) -> u64 {
+			return do_erase(k);
+		}
+
+		template<typename K>
+			requires detail::transparent_lookup<hash, key_equal>
+		auto erase(const K& k) -> u64 {
+			return do_erase(k);
+		}
+
+		/**
+		 * \brief Invokes \b func(const bucket_type&) for every element. Shards are distributed between
+		 * \b thread_count threads (including the calling one, the default only uses the calling one), every
+		 * shard is read-locked while it's being visited. If \b thread_count is larger than one, \b func has
+		 * to be safe to call from multiple threads at once.
+		 */
+		template<typename function>
+		void for_each(function&& func, u64 thread_count = 1) const {
+			std::atomic<u64> next_shard = 0;
+
+			auto worker = [&] {
+				for(u64 i = next_shard.fetch_add(1, std::memory_order_relaxed); i < shard_count; i = next_shard.fetch_add(1, std::memory_order_relaxed)) {
+					const shard& s = m_shards[i];
+					std::shared_lock lock(s.mutex);
+
+					for(const bucket_type& bucket : s.data) {
+						func(bucket);
+					}
+				}
+			};
+
+			thread_count = min(max(thread_count, u64(1)), shard_count);
+			dynamic_array<std::thread> threads;
+			threads.reserve(thread_count - 1);
+
+			for(u64 i = 1; i < thread_count; ++i) {
+				threads.emplace_back(worker);
+			}
+
+			worker();
+
+			for(std::thread& thread : threads) {
+				thread.join();
+			}
+		}
+
+		/**
+		 * \brief Reserves space for \b capacity elements, split evenly between the shards.
+		 */
+		void reserve(u64 capacity) {
+			const u64 shard_capacity = (capacity + shard_count - 1) / shard_count;
+
+			for(shard& s : m_shards) {
+				std::unique_lock lock(s.mutex);
+				s.data.reserve(shard_capacity);
+			}
+		}
+
+		void clear() {
+			for(shard& s : m_shards) {
+				std::unique_lock lock(s.mutex);
+				s.data.clear();
+			}
+		}
+
+		/**
+		 * \brief Returns the number of elements. Shards are locked one after another, the result is only
+		 * exact if no other thread modifies the map at the same time.
+		 */
+		[[nodiscard]] auto get_size() const -> u64 {
+			u64 size = 0;
+
+			for(const shard& s : m_shards) {
+				std::shared_lock lock(s.mutex);
+				size += s.data.get_size();
+			}
+
+			return size;
+		}
+		[[nodiscard]] auto is_empty() const -> bool {
+			return get_size() == 0;
+		}
+		[[nodiscard]] static constexpr auto get_shard_count() -> u64 {
+			return shard_count;
+		}
+
+		[[nodiscard]] auto get_memory_usage() const -> u64 {
+			u64 usage = 0;
+
+			for(const shard& s : m_shards) {
+				std::shared_lock lock(s.mutex);
+				usage += s.data.get_memory_usage();
+			}
+
+			return usage;
+		}
+	protected:
+		// every shard lives on its own cache line, this way locking one shard doesn't invalidate its neighbours
+		struct alignas(64) shard {
+			mutable std::shared_mutex mutex;
+			map_type data;
+		};
+
+		template<u64... indices>
+		concurrent_map(allocator_type& allocator, std::index_sequence<indices...>)
+			: m_shards{ shard{ {}, ((void)indices, map_type(allocator)) }... } {}
+
+		// the hash is remixed first, weak hashes (ie. the identity of small integers) would otherwise put
+		// every key into the same shard; the maps take the fingerprint from the lowest byte and the bucket
+		// from the highest bits of the same remixed hash, the shard comes from the bits right above the
+		// fingerprint, which keeps the bucket distribution inside of a shard independent from the selection
+		template<typename K>
+		[[nodiscard]] auto get_shard_index(const K& k) const -> u64 {
+			if constexpr(shard_count == 1) {
+				return 0;
+			}
+			else {
+				return (compute_hash(static_cast<u64>(m_hash(k))) >> shard_bit_offset) & (shard_count - 1);
+			}
+		}
+
+		template<typename K>
+		[[nodiscard]] auto get_shard(const K& k) -> shard& {
+			return m_shards[get_shard_index(k)];
+		}
+		template<typename K>
+		[[nodiscard]] auto get_shard(const K& k) const -> const shard& {
+			return m_shards[get_shard_index(k)];
+		}
+
+		template<typename K>
+		auto do_find(const K& k) const -> std::optional<element_type> {
+			const shard& s = get_shard(k);
+			std::shared_lock lock(s.mutex);
+
+			if(const auto it = s.data.find(k); it != s.data.end()) {
+				return it->second;
+			}
+
+			return std::nullopt;
+		}
+
+		template<typename K>
+		auto do_contains(const K& k) const -> bool {
+			const shard& s = get_shard(k);
+			std::shared_lock lock(s.mutex);
+
+			return s.data.contains(k);
+		}
+
+		template<typename K, typename function>
+		auto do_update(const K& k, function& func) -> bool {
+			shard& s = get_shard(k);
+			std::unique_lock lock(s.mutex);
+
+			const auto it = s.data.find(k);
+
+			if(it == s.data.end()) {
+				return false;
+			}
+
+			// the map only hands out const iterators from find(), the shard is exclusively locked
+			func(const_cast<bucket_type&>(*it).second);
+			return true;
+		}
+
+		template<typename K>
+		auto do_erase(const K& k) -> u64 {
+			shard& s = get_shard(k);
+			std::unique_lock lock(s.mutex);
+
+			return s.data.erase(k);
+		}
+	protected:
+		shard m_shards[shard_count];
+		[[no_unique_address]] hash m_hash;
+	};
+} // namespace utility
@@ -1,18 +1,29 @@
 #pragma once
+#include "utility/allocators/allocator_base.h"
 #include "utility/ranges.h"
 #include "utility/assert.h"
 
 namespace utility {
-	template<typename value, typename size = u64>
+	/**
+	 * \brief Contiguous, growable array.
+	 * \tparam value Type of the stored elements
+	 * \tparam size Type used for sizes and indices
+	 * \tparam alloc Allocator used for the element storage, stateful allocators (ie. a block_allocator)
+	 * have to be passed to the constructor and must outlive the array
+	 */
+	template<typename value, typename size = u64, allocator alloc = heap_allocator>
 	class dynamic_array {
 	public:
 		using element_type = value;
 		using size_type = size;
+		using allocator_type = alloc;
 
 		using const_iterator = const element_type*;
 		using iterator = element_type*;
 
 		dynamic_array() : m_data(nullptr), m_capacity(0), m_size(0) {}
+		dynamic_array(allocator_type& allocator) 
+			: m_data(nullptr), m_capacity(0), m_size(0), m_allocator(allocator) {}
 		dynamic_array(initializer_list<element_type> i_list)
 			: m_data(nullptr), m_capacity(0), m_size(0) {
 			reserve(i_list.size());
@@ -25,19 +36,19 @@ namespace utility {
 			reserve(s);
 
 			for(size_type i = 0; i < s; ++i) {
-				m_data[i] = v;
+				utility::construct_at(m_data + i, v);
 			}
 
 			m_size = s;
 		}
 		dynamic_array(const dynamic_array& other)
-			: m_data(nullptr), m_capacity(0), m_size(0) {
+			: m_data(nullptr), m_capacity(0), m_size(0), m_allocator(other.m_allocator) {
 			reserve(other.get_size());
 			construct(other.begin(), other.end(), other.get_size());
 
 			m_size = other.get_size();
 		}
-		dynamic_array(dynamic_array&& other) noexcept {
+		dynamic_array(dynamic_array&& other) noexcept : m_allocator(other.m_allocator) {
 			m_data = exchange(other.m_data, nullptr);
 			m_capacity = exchange(other.m_capacity, 0);
 			m_size = exchange(other.m_size, 0);
@@ -45,7 +56,7 @@ namespace utility {
 
 		~dynamic_array() {
 			clear();
-			utility::free(m_data);
+			deallocate();
 		}
 		
 		void push_back(const element_type& val) {
@@ -57,7 +68,7 @@ namespace utility {
 				m_data[m_size++] = val;
 			}
 			else {
-				construct_at(&m_data[m_size++], val);
+				utility::construct_at(&m_data[m_size++], val);
 			}
 		}
 		auto pop_back() -> element_type {
@@ -67,7 +78,10 @@ namespace utility {
 
 			--m_size;
 
-			return utility::move(m_data[m_size]);
+			element_type result = utility::move(m_data[m_size]);
+			utility::destroy_at(m_data + m_size);
+
+			return result;
 		}
 
 		template<typename... Args>
@@ -98,7 +112,7 @@ namespace utility {
 			}
 
 			// move existing elements to make space for the new elements
-			if constexpr(is_trivial_v<element_type>) {
+			if constexpr(is_trivially_relocatable_v<element_type>) {
 				utility::memmove(
 					m_data + index + num_elements_to_insert,
 					m_data + index,
@@ -123,29 +137,215 @@ namespace utility {
 			m_size += num_elements_to_insert;
 		}
 
-		void reserve(size_type new_capacity) {
-			if(new_capacity <= m_capacity) {
+		/**
+		 * \brief Appends the elements in the range [\b first, \b last) to the end of the array. Storage is
+		 * reserved once, contiguous ranges of trivial elements are copied with a single memcpy.
+		 */
+		template<typename iterator_type>
+		void append(iterator_type first, iterator_type last) {
+			if constexpr(std::is_convertible_v<iterator_type, const element_type*>) {
+				append(static_cast<const element_type*>(first), static_cast<size_type>(last - first));
+			}
+			else {
+				const size_type count = utility::distance(first, last);
+				grow(m_size + count);
+
+				utility::construct_range(m_data + m_size, first, last);
+				m_size += count;
+			}
+		}
+		/**
+		 * \brief Appends \b count elements starting at \b data to the end of the array. The source may point
+		 * into the array itself.
+		 */
+		void append(const element_type* data, size_type count) {
+			if(count == 0) {
 				return;
 			}
 
-			element_type* new_data = static_cast<element_type*>(utility::malloc(new_capacity * sizeof(element_type)));
-			ASSERT(new_data, "allocation failure");
+			if(m_size + count > m_capacity) {
+				// the source range may live in the current buffer, which is about to be released
+				const bool is_aliased = data >= m_data && data < m_data + m_size;
+				const size_type offset = is_aliased ? static_cast<size_type>(data - m_data) : 0;
+
+				grow(m_size + count);
+
+				if(is_aliased) {
+					data = m_data + offset;
+				}
+			}
 
 			if constexpr(is_trivial_v<element_type>) {
-				utility::memcpy(new_data, m_data, m_size * sizeof(element_type));
+				utility::memcpy(m_data + m_size, data, count * sizeof(element_type));
+			}
+			else {
+				utility::construct_range(m_data + m_size, data, data + count);
+			}
+
+			m_size += count;
+		}
+
+		/**
+		 * \brief Removes the element at \b pos, the following elements are shifted down to keep their order.
+		 * \return Iterator to the element which followed the removed one.
+		 */
+		auto erase(iterator pos) -> iterator {
+			return erase(pos, pos + 1);
+		}
+		/**
+		 * \brief Removes the elements in the range [\b first, \b last), the following elements are shifted
+		 * down to keep their order.
+		 * \return Iterator to the element which followed the removed range.
+		 */
+		auto erase(iterator first, iterator last) -> iterator {
+			if(first == last) {
+				return first;
+			}
+
+			const size_type count = static_cast<size_type>(last - first);
+
+			if constexpr(is_trivially_relocatable_v<element_type>) {
+				utility::destruct_range(first, last);
+				utility::memmove(first, last, static_cast<u64>(end() - last) * sizeof(element_type));
 			}
 			else {
-				construct_range(new_data, begin(), end());
-				destruct_range(begin(), end());
+				utility::move(last, end(), first);
+				utility::destruct_range(end() - count, end());
+			}
+
+			m_size -= count;
+			return first;
+		}
+		/**
+		 * \brief Removes the element at \b pos by replacing it with the last element. Doesn't preserve the
+		 * order of elements, but runs in constant time.
+		 * \return Iterator to the element which now occupies \b pos.
+		 */
+		auto erase_unordered(iterator pos) -> iterator {
+			ASSERT(pos >= begin() && pos < end(), "iterator out of range");
+			element_type* last = m_data + m_size - 1;
+
+			if(pos != last) {
+				if constexpr(is_trivially_relocatable_v<element_type>) {
+					utility::destroy_at(pos);
+					utility::memcpy(static_cast<void*>(pos), last, sizeof(element_type));
+				}
+				else {
+					*pos = utility::move(*last);
+					utility::destroy_at(last);
+				}
+			}
+			else {
+				utility::destroy_at(pos);
+			}
+
+			--m_size;
+			return pos;
+		}
+
+		/**
+		 * \brief Resizes the array to \b new_size elements, new elements are value-initialized.
+		 */
+		void resize(size_type new_size) {
+			if(new_size <= m_size) {
+				truncate(new_size);
+				return;
+			}
+
+			reserve(new_size);
+
+			if constexpr(is_trivial_v<element_type>) {
+				utility::memset(m_data + m_size, 0, (new_size - m_size) * sizeof(element_type));
+			}
+			else {
+				for(size_type i = m_size; i < new_size; ++i) {
+					utility::construct_at(m_data + i);
+				}
+			}
+
+			m_size = new_size;
+		}
+		/**
+		 * \brief Resizes the array to \b new_size elements, new elements are copies of \b v.
+		 */
+		void resize(size_type new_size, const element_type& v) {
+			if(new_size <= m_size) {
+				truncate(new_size);
+				return;
+			}
+
+			reserve(new_size);
+
+			for(size_type i = m_size; i < new_size; ++i) {
+				utility::construct_at(m_data + i, v);
 			}
 
-			utility::free(m_data);
+			m_size = new_size;
+		}
+		/**
+		 * \brief Resizes the array to \b new_size elements without initializing the new ones. Meant for
+		 * buffers which are filled directly afterwards (ie. by I/O or SIMD kernels).
+		 */
+		void resize_uninitialized(size_type new_size) {
+			static_assert(is_trivial_v<element_type>, "uninitialized resize requires a trivial element type");
+
+			reserve(new_size);
+			m_size = new_size;
+		}
+
+		/**
+		 * \brief Reduces the capacity to the current size, releases the storage if the array is empty.
+		 */
+		void shrink_to_fit() {
+			if(m_capacity == m_size) {
+				return;
+			}
+
+			if(m_size == 0) {
+				deallocate();
+				m_data = nullptr;
+				m_capacity = 0;
+				return;
+			}
+
+			element_type* new_data = static_cast<element_type*>(
+				m_allocator.get().allocate(m_size * sizeof(element_type), alignof(element_type))
+			);
+
+			ASSERT(new_data, "allocation failure");
+			utility::relocate_range(new_data, m_data, m_size);
+
+			deallocate();
+			m_data = new_data;
+			m_capacity = m_size;
+		}
+
+		void reserve(size_type new_capacity) {
+			if(new_capacity <= m_capacity) {
+				return;
+			}
+
+			// the allocator may be able to extend the current allocation (ie. if it's the most recent
+			// allocation in an arena), in which case nothing has to be relocated
+			if(m_data && m_allocator.get().try_expand(m_data, m_capacity * sizeof(element_type), new_capacity * sizeof(element_type))) {
+				m_capacity = new_capacity;
+				return;
+			}
+
+			element_type* new_data = static_cast<element_type*>(
+				m_allocator.get().allocate(new_capacity * sizeof(element_type), alignof(element_type))
+			);
+
+			ASSERT(new_data, "allocation failure");
+			utility::relocate_range(new_data, m_data, m_size);
+
+			deallocate();
 			m_data = new_data;
 			m_capacity = new_capacity;
 		}
 		void clear() {
 			if constexpr(!is_trivial_v<element_type>) {
-				destruct_range(begin(), end());
+				utility::destruct_range(begin(), end());
 			}
 
 			m_size = 0;
@@ -163,6 +363,22 @@ namespace utility {
 		}
 		[[nodiscard]] auto get_capacity() const -> size_type { return m_capacity; }
 		[[nodiscard]] auto get_size() const -> size_type { return m_size; }
+
+		/**
+		 * \brief Returns the number of bytes allocated by the array, including memory owned by the
+		 * elements themselves (if they expose get_memory_usage()).
+		 */
+		[[nodiscard]] auto get_memory_usage() const -> u64 {
+			u64 usage = m_capacity * sizeof(element_type);
+
+			if constexpr(requires(const element_type& e) { e.get_memory_usage(); }) {
+				for(const element_type& element : *this) {
+					usage += element.get_memory_usage();
+				}
+			}
+
+			return usage;
+		}
 		void set_size(size_type s)  { m_size = s; }
 
 		[[nodiscard]] auto begin() -> iterator { return m_data; }
@@ -182,9 +398,16 @@ namespace utility {
 			return *this;
 		}
 		auto operator=(dynamic_array&& other) noexcept -> dynamic_array& {
-			m_data = exchange(other.m_data, nullptr);
-			m_capacity = exchange(other.m_capacity, 0);
-			m_size = exchange(other.m_size, 0);
+			if(this != &other) {
+				clear();
+				deallocate();
+
+				m_data = exchange(other.m_data, nullptr);
+				m_capacity = exchange(other.m_capacity, 0);
+				m_size = exchange(other.m_size, 0);
+				m_allocator = other.m_allocator;
+			}
+
 			return *this;
 		}
 		[[nodiscard]] auto operator[](size_type index) -> element_type& {
@@ -196,17 +419,44 @@ namespace utility {
 			return m_data[index];
 		}
 	protected:
+		// reserves space for at least required_size elements, grows geometrically
+		void grow(size_type required_size) {
+			if(required_size > m_capacity) {
+				reserve(max(required_size, m_capacity * 2));
+			}
+		}
+
+		void truncate(size_type new_size) {
+			if constexpr(!is_trivial_v<element_type>) {
+				utility::destruct_range(m_data + new_size, m_data + m_size);
+			}
+
+			m_size = new_size;
+		}
+
+		void deallocate() {
+			if(m_data) {
+				m_allocator.get().deallocate(m_data, m_capacity * sizeof(element_type));
+			}
+		}
+
 		void construct(const_iterator begin, const_iterator end, size_type count) {
 			if constexpr(is_trivial_v<element_type>) {
 				utility::memcpy(m_data, begin, count * sizeof(element_type));
 			}
 			else {
-				construct_range(m_data, begin, end);
+				utility::construct_range(m_data, begin, end);
 			}
 		}
 	protected:
 		element_type* m_data;
 		size_type m_capacity;
 		size_type m_size;
+
+		[[no_unique_address]] detail::allocator_reference<allocator_type> m_allocator;
 	};
+
+	// the array only refers to its elements through a pointer
+	template<typename value, typename size, typename alloc>
+	struct is_trivially_relocatable<dynamic_array<value, size, alloc>> : true_type {};
 } // namespace utility
@@ -1,13 +1,15 @@
 #pragma once
+#include "utility/allocators/allocator_base.h"
 #include "utility/containers/string_view.h"
 #include "utility/ranges.h"
 
 namespace utility {
-	template<typename value, typename size>
+	template<typename value, typename size, allocator alloc = heap_allocator>
 	class dynamic_string_base {
 	public:
 		using element_type = value;
 		using size_type = size;
+		using allocator_type = alloc;
 
 		using const_iterator = const element_type*;
 		using iterator = element_type*;
@@ -17,6 +19,18 @@ namespace utility {
 			m_data[0] = 0;
 			m_size = 0;
 		}
+		dynamic_string_base(allocator_type& allocator) : m_allocator(allocator) {
+			reserve(0);
+			m_data[0] = 0;
+			m_size = 0;
+		}
+		dynamic_string_base(const element_type* str, allocator_type& allocator) : m_allocator(allocator) {
+			const size_type length = string_len(str);
+			reserve(length);
+			m_size = length;
+			utility::memcpy(m_data, str, m_size * sizeof(element_type));
+			m_data[m_size] = 0;
+		}
 		dynamic_string_base(const element_type* str) {
 			const size_type length = string_len(str);
 			reserve(length);
@@ -24,23 +38,30 @@ namespace utility {
 			utility::memcpy(m_data, str, m_size * sizeof(element_type));
 			m_data[m_size] = 0;
 		}
+		template<typename view_size>
+		dynamic_string_base(const string_view_base<element_type, view_size>& view) {
+			reserve(view.get_size());
+			m_size = view.get_size();
+			utility::memcpy(m_data, view.get_data(), m_size * sizeof(element_type));
+			m_data[m_size] = 0;
+		}
 		dynamic_string_base(element_type c) {
 			reserve(1);
 			m_size = 1;
 			m_data[0] = c;
 			m_data[m_size] = 0;
 		}
-		dynamic_string_base(const dynamic_string_base& other) {
+		dynamic_string_base(const dynamic_string_base& other) : m_allocator(other.m_allocator) {
 			reserve(other.get_size());
 			m_size = other.get_size();
 			utility::memcpy(m_data, other.get_data(), (m_size + 1) * sizeof(element_type));
 		}
 		dynamic_string_base(dynamic_string_base&& other) noexcept :
-		m_data(exchange(other.m_data, nullptr)), m_capacity(exchange(other.m_capacity, 0)), m_size(exchange(other.m_size, 0)) {}
+		m_data(exchange(other.m_data, nullptr)), m_capacity(exchange(other.m_capacity, 0)), m_size(exchange(other.m_size, 0)), m_allocator(other.m_allocator) {}
 
 		~dynamic_string_base() {
 			if(m_data) {
-				utility::free(m_data);
+				deallocate();
 				m_size = 0;
 				m_capacity = 0;
 				m_data = nullptr;
@@ -104,18 +125,21 @@ namespace utility {
 				return;
 			}
 
-			element_type* new_data = static_cast<element_type*>(utility::malloc(new_capacity * sizeof(element_type)));
-			ASSERT(new_data, "allocation failure\n");
-
-			if constexpr(is_trivial_v<element_type>) {
-				utility::memcpy(new_data, m_data, m_size * sizeof(element_type));
-			}
-			else {
-				construct_range(new_data, begin(), end());
-				destruct_range(begin(), end());
+			// the allocator may be able to extend the current allocation (ie. if it's the most recent
+			// allocation in an arena), in which case nothing has to be relocated
+			if(m_data && m_allocator.get().try_expand(m_data, m_capacity * sizeof(element_type), new_capacity * sizeof(element_type))) {
+				m_capacity = new_capacity;
+				return;
 			}
 
-			utility::free(m_data);
+			element_type* new_data = static_cast<element_type*>(
+				m_allocator.get().allocate(new_capacity * sizeof(element_type), alignof(element_type))
+			);
+
+			ASSERT(new_data, "allocation failure\n");
+			utility::relocate_range(new_data, m_data, m_size);
+
+			deallocate();
 			m_data = new_data;
 			m_capacity = new_capacity;
 		}
@@ -166,7 +190,7 @@ namespace utility {
 			m_size = 0;
 		}
 		auto trim() -> dynamic_string_base {
-			dynamic_string_base result;
+			dynamic_string_base result(m_allocator.get());
 			size_type index = {};
 			size_type start_index;
 
@@ -177,7 +201,7 @@ namespace utility {
 
 			// all spaces
 			if(m_data[index] == 0) {
-				return {};
+				return result;
 			}
 
 			start_index = index;
@@ -271,7 +295,7 @@ namespace utility {
 				length = count;
 			}
 
-			dynamic_string_base new_string;
+			dynamic_string_base new_string(m_allocator.get());
 			new_string.reserve(length);
 			new_string.m_size = length;
 
@@ -297,6 +321,7 @@ namespace utility {
 		}
 		[[nodiscard]] auto get_capacity() const -> size_type { return m_capacity; }
 		[[nodiscard]] auto get_size() const -> size_type { return m_size; }
+		[[nodiscard]] auto get_memory_usage() const -> u64 { return m_capacity * sizeof(element_type); }
 		[[nodiscard]] auto begin() -> iterator { return m_data; }
 		[[nodiscard]] auto end() -> iterator { return m_data + m_size; }
 		[[nodiscard]] auto begin() const -> const_iterator { return m_data; }
@@ -317,6 +342,20 @@ namespace utility {
 
 			return true;
 		}
+		template<typename view_size>
+		[[nodiscard]] auto operator==(const string_view_base<element_type, view_size>& other) const -> bool {
+			if(other.get_size() != m_size) {
+				return false;
+			}
+
+			for(size_type i = 0; i < m_size; ++i) {
+				if(other[i] != m_data[i]) {
+					return false;
+				}
+			}
+
+			return true;
+		}
 		[[nodiscard]] auto operator==(const dynamic_string_base& other) const -> bool {
 			if(other.get_size() != m_size) {
 				return false;
@@ -372,8 +411,7 @@ namespace utility {
 		}
 		auto operator=(const dynamic_string_base& other) -> dynamic_string_base& {
 			if(this != &other) {
-				utility::free(m_data);
-
+				m_size = 0; // no need to preserve the current contents
 				reserve(other.get_size());
 				m_size = other.get_size();
 				utility::memcpy(m_data, other.get_data(), (m_size + 1) * sizeof(element_type));
@@ -383,8 +421,9 @@ namespace utility {
 		}
 		auto operator=(dynamic_string_base&& other) noexcept -> dynamic_string_base& {
 			if(this != &other) {
-				utility::free(m_data);
+				deallocate();
 
+				m_allocator = other.m_allocator;
 				m_capacity = exchange(other.m_capacity, 0);
 				m_size = exchange(other.m_size, 0);
 				m_data = exchange(other.m_data, nullptr);
@@ -435,11 +474,17 @@ namespace utility {
 			insert(end(), data, data + s);
 		}
 	protected:
+		void deallocate() {
+			if(m_data) {
+				m_allocator.get().deallocate(m_data, m_capacity * sizeof(element_type));
+			}
+		}
+
 		template<typename type, typename... types>
 		void append_impl(const char* format, const type& first, const types&... rest) {
 			if(const char* open_brace = std::strstr(format, "{}")) {
 				write(format, open_brace - format);
-				stream_writer<type, dynamic_string_base<value, size>>::write(first, *this);
+				stream_writer<type, dynamic_string_base>::write(first, *this);
 				append_impl(open_brace + 2, rest...);
 			}
 			else {
@@ -449,7 +494,7 @@ namespace utility {
 
 		template<typename type>
 		void append_impl(const type& first) {
-			stream_writer<type, dynamic_string_base<value, size>>::write(first, *this);
+			stream_writer<type, dynamic_string_base>::write(first, *this);
 		}
 	public:
 		static constexpr size_type invalid_pos = limits<size_type>::max();
@@ -457,19 +502,37 @@ namespace utility {
 		element_type* m_data = nullptr;
 		size_type m_capacity = size_type();
 		size_type m_size = size_type();
+
+		[[no_unique_address]] detail::allocator_reference<allocator_type> m_allocator;
 	};
 
-	template<typename stream_type, typename char_type, typename size_type>
-	struct stream_writer<dynamic_string_base<char_type, size_type>, stream_type> {
-		static void write(const dynamic_string_base<char_type, size_type>& value, stream_type& str) {
+	template<typename d, typename s, typename a>
+	struct is_trivially_relocatable<dynamic_string_base<d, s, a>> : true_type {};
+
+	template<typename stream_type, typename char_type, typename size_type, typename allocator_type>
+	struct stream_writer<dynamic_string_base<char_type, size_type, allocator_type>, stream_type> {
+		static void write(const dynamic_string_base<char_type, size_type, allocator_type>& value, stream_type& str) {
 			str.write(value.get_data(), value.get_size());
 		}
 	};
 
-	template<typename d, typename s>
-	struct hash<dynamic_string_base<d, s>> {
-		auto operator()(const dynamic_string_base<d, s>& obj) const noexcept -> u64 {
-			return compute_hash(obj.get_data(), sizeof(char) * obj.get_size());
+	/**
+	 * \brief Transparent string hash, strings, string views and null-terminated strings with the same
+	 * contents produce identical hashes, which allows maps to be queried without constructing a string.
+	 */
+	template<typename d, typename s, typename a>
+	struct hash<dynamic_string_base<d, s, a>> {
+		using is_transparent = void;
+
+		auto operator()(const dynamic_string_base<d, s, a>& obj) const noexcept -> u64 {
+			return compute_hash(obj.get_data(), sizeof(d) * obj.get_size());
+		}
+		template<typename view_size>
+		auto operator()(const string_view_base<d, view_size>& obj) const noexcept -> u64 {
+			return hash<string_view_base<d, view_size>>()(obj);
+		}
+		auto operator()(const d* str) const noexcept -> u64 {
+			return compute_hash(str, sizeof(d) * string_len(str));
 		}
 	};
 
@@ -0,0 +1,672 @@
+#pragma once
+#include "utility/containers/map.h"
+
+#include <bit>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define UTILITY_FLAT_MAP_SSE2
+#endif
+
+namespace utility {
+	namespace detail {
+		using control_byte = i8;
+
+		// full slots hold the 7 low bits of the hash, free slots have the high bit set
+		static constexpr control_byte control_empty = -128;  // 0b10000000
+		static constexpr control_byte control_deleted = -2;  // 0b11111110
+
+#if defined(__AVX2__)
+		/**
+		 * \brief Group of 32 control bytes, every match is a single compare + movemask.
+		 */
+		class control_group {
+		public:
+			using mask_type = u32;
+			static constexpr u64 width = 32;
+			static constexpr u32 index_shift = 0;
+
+			explicit control_group(const control_byte* position)
+				: m_control(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(position))) {}
+
+			[[nodiscard]] auto match(control_byte h2) const -> mask_type {
+				return static_cast<mask_type>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_set1_epi8(h2), m_control)));
+			}
+			[[nodiscard]] auto match_empty() const -> mask_type {
+				return match(control_empty);
+			}
+			[[nodiscard]] auto match_empty_or_deleted() const -> mask_type {
+				return static_cast<mask_type>(_mm256_movemask_epi8(m_control));
+			}
+		private:
+			__m256i m_control;
+		};
+#elif defined(UTILITY_FLAT_MAP_SSE2)
+		/**
+		 * \brief Group of 16 control bytes, every match is a single compare + movemask.
+		 */
+		class control_group {
+		public:
+			using mask_type = u32;
+			static constexpr u64 width = 16;
+			static constexpr u32 index_shift = 0;
+
+			explicit control_group(const control_byte* position)
+				: m_control(_mm_loadu_si128(reinterpret_cast<const __m128i*>(position))) {}
+
+			[[nodiscard]] auto match(control_byte h2) const -> mask_type {
+				return static_cast<mask_type>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), m_control)));
+			}
+			[[nodiscard]] auto match_empty() const -> mask_type {
+				return match(control_empty);
+			}
+			[[nodiscard]] auto match_empty_or_deleted() const -> mask_type {
+				return static_cast<mask_type>(_mm_movemask_epi8(m_control));
+			}
+		private:
+			__m128i m_control;
+		};
+#else
+		/**
+		 * \brief Portable group of 8 control bytes, matched with bit tricks on a single 64-bit word.
+		 * match() can report false positives, which are filtered out by the key comparison.
+		 */
+		class control_group {
+			static constexpr u64 lsbs = 0x0101010101010101ull;
+			static constexpr u64 msbs = 0x8080808080808080ull;
+		public:
+			using mask_type = u64;
+			static constexpr u64 width = 8;
+			static constexpr u32 index_shift = 3;
+
+			explicit control_group(const control_byte* position) {
+				utility::memcpy(&m_control, position, sizeof(m_control));
+			}
+
+			[[nodiscard]] auto match(control_byte h2) const -> mask_type {
+				const u64 x = m_control ^ (lsbs * static_cast<u8>(h2));
+				return (x - lsbs) & ~x & msbs;
+			}
+			[[nodiscard]] auto match_empty() const -> mask_type {
+				return m_control & ~(m_control << 6) & msbs;
+			}
+			[[nodiscard]] auto match_empty_or_deleted() const -> mask_type {
+				return m_control & msbs;
+			}
+		private:
+			u64 m_control;
+		};
+#endif
+	} // namespace detail
+
+	/**
+	 * \brief Hash-based unordered map with Swiss-table style probing. Exposes the same interface as the
+	 * map. Every slot has a control byte holding 7 bits of the hash, lookups compare a whole group of
+	 * control bytes at once (32 with AVX2, 16 with SSE2 and 8 otherwise) and only touch keys whose
+	 * control byte matches. Values are stored densely, like in the map.
+	 * \tparam key Type to use as a key type
+	 * \tparam value Type to use as the value type, void turns the map into a set
+	 * \tparam hash Hash to use when hashing the key type
+	 * \tparam key_equal Key equality operator, lookups are transparent if both functors are
+	 * \tparam alloc Allocator used for both the values and the control bytes
+	 */
+	template<
+		typename key,
+		typename value,
+		typename hash = hash<key>,
+		typename key_equal = std::equal_to<>,
+		allocator alloc = heap_allocator
+	>
+	class flat_map {
+		using group = detail::control_group;
+		using slot_type = u32; // index into m_values
+
+		static constexpr u64 invalid_slot = limits<u64>::max();
+	public:
+		using bucket_type = typename std::conditional_t<is_map_v<value>, std::pair<key, value>, key>;
+		using bucket_container_type = dynamic_array<bucket_type, u64, alloc>;
+
+		using const_iterator = typename bucket_container_type::const_iterator;
+		using iterator = typename bucket_container_type::iterator;
+
+		using element_type = value;
+		using key_type = key;
+		using allocator_type = alloc;
+
+		template<typename K>
+		static constexpr bool is_iterator = std::is_convertible_v<K, iterator> || std::is_convertible_v<K, const_iterator>;
+
+		flat_map() = default;
+		flat_map(allocator_type& allocator) : m_values(allocator), m_allocator(allocator) {}
+		flat_map(u64 capacity) {
+			reserve(capacity);
+		}
+		flat_map(initializer_list<bucket_type> ilist) {
+			reserve(ilist.size());
+
+			for(const auto& i : ilist) {
+				emplace(i);
+			}
+		}
+		flat_map(const flat_map& other)
+			: m_values(other.m_values), m_equal(other.m_equal), m_hash(other.m_hash),
+			m_max_load_factor(other.m_max_load_factor), m_allocator(other.m_allocator) {
+			copy_slots(other);
+		}
+		flat_map(flat_map&& other) noexcept
+			: m_values(utility::move(other.m_values)), m_equal(other.m_equal), m_hash(other.m_hash),
+			m_max_load_factor(other.m_max_load_factor), m_allocator(other.m_allocator) {
+			take_slots(other);
+		}
+
+		~flat_map() {
+			deallocate_slots();
+		}
+
+		auto operator=(const flat_map& other) -> flat_map& {
+			if(&other != this) {
+				deallocate_slots();
+
+				m_values = other.m_values;
+				m_hash = other.m_hash;
+				m_equal = other.m_equal;
+				m_max_load_factor = other.m_max_load_factor;
+
+				copy_slots(other);
+			}
+
+			return *this;
+		}
+		auto operator=(flat_map&& other) noexcept -> flat_map& {
+			if(&other != this) {
+				deallocate_slots();
+
+				m_values = utility::move(other.m_values);
+				m_hash = other.m_hash;
+				m_equal = other.m_equal;
+				m_max_load_factor = other.m_max_load_factor;
+				m_allocator = other.m_allocator;
+
+				take_slots(other);
+			}
+
+			return *this;
+		}
+
+		template <typename q = value, enable_if_t<is_map_v<q>, bool> = true>
+		auto operator[](const key_type& k) -> q& {
+			return do_try_emplace(k).first->second;
+		}
+
+		template <typename q = value, enable_if_t<is_map_v<q>, bool> = true>
+		auto operator[](key_type&& k) -> q& {
+			return do_try_emplace(utility::move(k)).first->second;
+		}
+
+		template <typename K, typename q = value, enable_if_t<is_map_v<q>, bool> = true>
+			requires detail::transparent_lookup<hash, key_equal>
+		auto operator[](K&& k) -> q& {
+			return do_try_emplace(utility::forward<K>(k)).first->second;
+		}
+
+		template <typename q = value, enable_if_t<is_map_v<q>, bool> = true>
+		[[nodiscard]] auto at(const key_type& k) -> const q& {
+			return do_at(k);
+		}
+
+		template <typename K, typename q = value, enable_if_t<is_map_v<q>, bool> = true>
+			requires detail::transparent_lookup<hash, key_equal>
+		[[nodiscard]] auto at(const K& k) -> const q& {
+			return do_at(k);
+		}
+
+		auto contains(const key_type& k) const -> bool {
+			return find_slot(k) != invalid_slot;
+		}
+
+		template<typename K>
+			requires detail::transparent_lookup<hash, key_equal>
+		auto contains(const K& k) const -> bool {
+			return find_slot(k) != invalid_slot;
+		}
+
+		[[nodiscard]] auto find(const key_type& k) const -> const_iterator {
+			return do_find(k);
+		}
+
+		template<typename K>
+			requires detail::transparent_lookup<hash, key_equal>
+		[[nodiscard]] auto find(const K& k) const -> const_iterator {
+			return do_find(k);
+		}
+
+		auto insert(const bucket_type& v) -> std::pair<iterator, bool> {
+			return emplace(v);
+		}
+
+		auto insert(bucket_type&& v) -> std::pair<iterator, bool> {
+			return emplace(utility::move(v));
+		}
+
+		template<class... Args>
+		auto emplace(Args&&... args) -> std::pair<iterator, bool> {
+			const auto& k = get_key(m_values.emplace_back(utility::forward<Args>(args)...));
+
+			if(const u64 slot = find_slot(k); slot != invalid_slot) {
+				m_values.pop_back();
+				return { begin() + m_slots[slot], false };
+			}
+
+			const u64 value_idx = m_values.get_size() - 1;
+			insert_slot(mixed_hash(k), value_idx);
+
+			return { begin() + value_idx, true };
+		}
+
+		template <typename q = value, typename... Args, enable_if_t<is_map_v<q>, bool> = true>
+		auto try_emplace(const key_type& k, Args&&... args) -> std::pair<iterator, bool> {
+			return do_try_emplace(k, utility::forward<Args>(args)...);
+		}
+
+		template <typename q = value, typename... Args, enable_if_t<is_map_v<q>, bool> = true>
+		auto try_emplace(key_type&& k, Args&&... args) -> std::pair<iterator, bool> {
+			return do_try_emplace(utility::move(k), utility::forward<Args>(args)...);
+		}
+
+		template <typename K, typename q = value, typename... Args, enable_if_t<is_map_v<q>, bool> = true>
+			requires detail::transparent_lookup<hash, key_equal> && (!is_iterator<K>)
+		auto try_emplace(K&& k, Args&&... args) -> std::pair<iterator, bool> {
+			return do_try_emplace(utility::forward<K>(k), utility::forward<Args>(args)...);
+		}
+
+		/**
+		 * \brief Removes the element with the specified key, if it exists. The slot is marked as deleted
+		 * and the last element is moved into the vacated value slot.
+		 * \return Number of removed elements (0 or 1).
+		 */
+		auto erase(const key_type& k) -> u64 {
+			return do_erase_key(k);
+		}
+
+		template<typename K>
+			requires detail::transparent_lookup<hash, key_equal> && (!is_iterator<K>)
+		auto erase(const K& k) -> u64 {
+			return do_erase_key(k);
+		}
+
+		/**
+		 * \brief Removes the element at \b it (ie. the result of find()), the last element is moved into
+		 * its slot.
+		 * \return Iterator to the element which now occupies the slot of the removed one.
+		 */
+		auto erase(const_iterator it) -> iterator {
+			const u64 value_idx = static_cast<u64>(it - begin());
+			do_erase(locate_value(value_idx));
+
+			return begin() + value_idx;
+		}
+
+		/**
+		 * \brief Removes every element for which \b predicate returns true.
+		 * \return Number of removed elements.
+		 */
+		template<typename predicate_type>
+		auto erase_if(predicate_type&& predicate) -> u64 {
+			const u64 old_size = get_size();
+
+			// walk backwards, erasing moves the last element (which has already been visited) into the hole
+			for(u64 idx = old_size; idx > 0; --idx) {
+				if(predicate(m_values[idx - 1])) {
+					erase(begin() + (idx - 1));
+				}
+			}
+
+			return old_size - get_size();
+		}
+
+		void reserve(u64 capacity) {
+			m_values.reserve(capacity);
+			const u64 slot_count = calc_slot_count(capacity);
+
+			if(slot_count > m_capacity) {
+				rebuild(slot_count);
+			}
+		}
+
+		/**
+		 * \brief Sets the fraction of slots which may be occupied (including deleted slots) before the
+		 * table grows. Higher load factors save memory at the cost of longer probe sequences.
+		 */
+		void set_max_load_factor(f32 load_factor) {
+			ASSERT(load_factor > 0.0f && load_factor < 1.0f, "invalid load factor\n");
+			m_max_load_factor = load_factor;
+
+			if(m_capacity > 0) {
+				rebuild(max(m_capacity, calc_slot_count(get_size())));
+			}
+		}
+
+		void clear() {
+			m_values.clear();
+
+			if(m_capacity > 0) {
+				reset_control();
+			}
+		}
+
+		[[nodiscard]] auto begin() noexcept -> iterator { return m_values.begin(); }
+		[[nodiscard]] auto begin() const noexcept -> const_iterator { return m_values.begin(); }
+		[[nodiscard]] auto end() noexcept -> iterator { return m_values.end(); }
+		[[nodiscard]] auto end() const noexcept -> const_iterator { return m_values.end(); }
+
+		[[nodiscard]] auto get_size() const noexcept -> u64 {
+			return m_values.get_size();
+		}
+		[[nodiscard]] auto is_empty() const noexcept -> bool {
+			return m_values.is_empty();
+		}
+		[[nodiscard]] auto get_capacity() const noexcept -> u64 {
+			return m_capacity;
+		}
+		[[nodiscard]] static constexpr auto get_group_width() -> u64 {
+			return group::width;
+		}
+
+		/**
+		 * \brief Returns the number of bytes allocated by the map (control bytes, slots and values).
+		 */
+		[[nodiscard]] auto get_memory_usage() const -> u64 {
+			return m_values.get_memory_usage() + (m_capacity ? get_allocation_size(m_capacity) : 0);
+		}
+	protected:
+		template<typename K>
+		[[nodiscard]] auto mixed_hash(const K& k) const -> u64 {
+			return compute_hash(m_hash(k));
+		}
+
+		[[nodiscard]] static auto get_h1(u64 h) -> u64 {
+			return h >> 7;
+		}
+		[[nodiscard]] static auto get_h2(u64 h) -> detail::control_byte {
+			return static_cast<detail::control_byte>(h & 0x7F);
+		}
+
+		[[nodiscard]] static constexpr auto get_key(const bucket_type& vt) -> const key_type& {
+			if constexpr(is_map_v<value>) {
+				return vt.first;
+			}
+			else {
+				return vt;
+			}
+		}
+
+		[[nodiscard]] static auto get_match_index(typename group::mask_type mask) -> u64 {
+			return static_cast<u64>(std::countr_zero(mask)) >> group::index_shift;
+		}
+
+		// walks the probe sequence of h, invokes func(slot) for every slot whose control byte matches
+		// the hash, stops once func returns true or a group with an empty slot is reached
+		template<typename function>
+		[[nodiscard]] auto probe(u64 h, function&& func) const -> u64 {
+			if(m_capacity == 0) {
+				return invalid_slot;
+			}
+
+			const detail::control_byte h2 = get_h2(h);
+			u64 offset = get_h1(h) & m_mask;
+			u64 step = 0;
+
+			while(true) {
+				const group g(m_control + offset);
+
+				for(auto mask = g.match(h2); mask != 0; mask &= mask - 1) {
+					const u64 slot = (offset + get_match_index(mask)) & m_mask;
+
+					if(func(slot)) {
+						return slot;
+					}
+				}
+
+				if(g.match_empty() != 0) {
+					return invalid_slot;
+				}
+
+				step += group::width;
+				offset = (offset + step) & m_mask;
+			}
+		}
+
+		template<typename K>
+		[[nodiscard]] auto find_slot(const K& k) const -> u64 {
+			return probe(mixed_hash(k), [&](u64 slot) {
+				return m_equal(k, get_key(m_values[m_slots[slot]]));
+			});
+		}
+
+		// returns the slot which refers to value_idx, the value has to be in the table
+		[[nodiscard]] auto locate_value(u64 value_idx) const -> u64 {
+			return probe(mixed_hash(get_key(m_values[value_idx])), [&](u64 slot) {
+				return m_slots[slot] == value_idx;
+			});
+		}
+
+		[[nodiscard]] auto find_first_free(u64 h) const -> u64 {
+			u64 offset = get_h1(h) & m_mask;
+			u64 step = 0;
+
+			while(true) {
+				const group g(m_control + offset);
+
+				if(const auto mask = g.match_empty_or_deleted(); mask != 0) {
+					return (offset + get_match_index(mask)) & m_mask;
+				}
+
+				step += group::width;
+				offset = (offset + step) & m_mask;
+			}
+		}
+
+		template<typename K>
+		auto do_find(const K& k) const -> const_iterator {
+			const u64 slot = find_slot(k);
+			return slot == invalid_slot ? end() : begin() + m_slots[slot];
+		}
+
+		template <typename K, typename q = value, enable_if_t<is_map_v<q>, bool> = true>
+		auto do_at(const K& k) -> const q& {
+			if(const u64 slot = find_slot(k); slot != invalid_slot) {
+				return m_values[m_slots[slot]].second;
+			}
+
+			static const element_type default_element{};
+			ASSERT(false, "key not found\n");
+
+			return default_element;
+		}
+
+		template <typename K, typename... Args>
+		auto do_try_emplace(K&& k, Args&&... args) -> std::pair<iterator, bool> {
+			const u64 h = mixed_hash(k);
+			const u64 slot = probe(h, [&](u64 s) {
+				return m_equal(k, get_key(m_values[m_slots[s]]));
+			});
+
+			if(slot != invalid_slot) {
+				return { begin() + m_slots[slot], false };
+			}
+
+			m_values.emplace_back(
+				std::piecewise_construct,
+				std::forward_as_tuple(utility::forward<K>(k)),
+				std::forward_as_tuple(utility::forward<Args>(args)...)
+			);
+
+			const u64 value_idx = m_values.get_size() - 1;
+			insert_slot(h, value_idx);
+
+			return { begin() + value_idx, true };
+		}
+
+		template<typename K>
+		auto do_erase_key(const K& k) -> u64 {
+			const u64 slot = find_slot(k);
+
+			if(slot == invalid_slot) {
+				return 0;
+			}
+
+			do_erase(slot);
+			return 1;
+		}
+
+		void do_erase(u64 slot) {
+			const u64 value_idx = m_slots[slot];
+			const u64 last_value_idx = m_values.get_size() - 1;
+
+			set_control(slot, detail::control_deleted);
+
+			// the last value is about to be moved into the hole, redirect its slot
+			if(value_idx != last_value_idx) {
+				m_slots[locate_value(last_value_idx)] = static_cast<slot_type>(value_idx);
+			}
+
+			m_values.erase_unordered(m_values.begin() + value_idx);
+		}
+
+		// the value at value_idx is already in m_values
+		void insert_slot(u64 h, u64 value_idx) {
+			u64 slot = m_capacity ? find_first_free(h) : invalid_slot;
+
+			if(slot == invalid_slot || (m_growth_left == 0 && m_control[slot] == detail::control_empty)) {
+				// rebuilding reinserts every value, including the new one; rehashing in place has to free at
+				// least 7/32 of the load budget, otherwise erase + insert churn close to the maximum load would
+				// rebuild the table every few operations
+				const bool in_place = m_capacity && get_size() * 32 <= get_max_load(m_capacity) * 25;
+				rebuild(in_place ? m_capacity : max(m_capacity * 2, calc_slot_count(get_size())));
+				return;
+			}
+
+			m_growth_left -= m_control[slot] == detail::control_empty;
+			set_control(slot, get_h2(h));
+			m_slots[slot] = static_cast<slot_type>(value_idx);
+		}
+
+		void set_control(u64 slot, detail::control_byte c) {
+			m_control[slot] = c;
+
+			// the first group is mirrored after the last slot, so unaligned group loads never wrap
+			if(slot < group::width - 1) {
+				m_control[m_capacity + slot] = c;
+			}
+		}
+
+		[[nodiscard]] auto get_max_load(u64 capacity) const -> u64 {
+			return min(static_cast<u64>(static_cast<f32>(capacity) * m_max_load_factor), capacity - 1);
+		}
+
+		[[nodiscard]] auto calc_slot_count(u64 size) const -> u64 {
+			u64 capacity = group::width;
+
+			while(get_max_load(capacity) < size) {
+				capacity *= 2;
+			}
+
+			return capacity;
+		}
+
+		[[nodiscard]] static constexpr auto get_control_size(u64 capacity) -> u64 {
+			return (capacity + group::width - 1 + alignof(slot_type) - 1) & ~(alignof(slot_type) - 1);
+		}
+		[[nodiscard]] static constexpr auto get_allocation_size(u64 capacity) -> u64 {
+			return get_control_size(capacity) + capacity * sizeof(slot_type);
+		}
+
+		void allocate_slots(u64 capacity) {
+			void* memory = m_allocator.get().allocate(get_allocation_size(capacity), alignof(slot_type));
+			ASSERT(memory, "allocation failure\n");
+
+			m_control = static_cast<detail::control_byte*>(memory);
+			m_slots = reinterpret_cast<slot_type*>(static_cast<u8*>(memory) + get_control_size(capacity));
+			m_capacity = capacity;
+			m_mask = capacity - 1;
+		}
+
+		void deallocate_slots() {
+			if(m_control) {
+				m_allocator.get().deallocate(m_control, get_allocation_size(m_capacity));
+			}
+
+			m_control = nullptr;
+			m_slots = nullptr;
+			m_capacity = 0;
+			m_mask = 0;
+			m_growth_left = 0;
+		}
+
+		void reset_control() {
+			utility::memset(m_control, detail::control_empty, m_capacity + group::width - 1);
+			m_growth_left = get_max_load(m_capacity);
+		}
+
+		void rebuild(u64 capacity) {
+			deallocate_slots();
+			allocate_slots(capacity);
+			reset_control();
+
+			for(u64 value_idx = 0; value_idx < m_values.get_size(); ++value_idx) {
+				const u64 h = mixed_hash(get_key(m_values[value_idx]));
+				const u64 slot = find_first_free(h);
+
+				set_control(slot, get_h2(h));
+				m_slots[slot] = static_cast<slot_type>(value_idx);
+				--m_growth_left;
+			}
+		}
+
+		void copy_slots(const flat_map& other) {
+			if(other.m_capacity == 0) {
+				return;
+			}
+
+			allocate_slots(other.m_capacity);
+			utility::memcpy(m_control, other.m_control, get_allocation_size(m_capacity));
+			m_growth_left = other.m_growth_left;
+		}
+
+		void take_slots(flat_map& other) {
+			m_control = exchange(other.m_control, nullptr);
+			m_slots = exchange(other.m_slots, nullptr);
+			m_capacity = exchange(other.m_capacity, 0);
+			m_mask = exchange(other.m_mask, 0);
+			m_growth_left = exchange(other.m_growth_left, 0);
+		}
+	protected:
+		bucket_container_type m_values;
+
+		detail::control_byte* m_control = nullptr; // control byte of every slot, followed by the mirrored first group
+		slot_type* m_slots = nullptr;
+		u64 m_capacity = 0;                        // number of slots, always a power of two
+		u64 m_mask = 0;
+		u64 m_growth_left = 0;                     // number of empty slots which can be filled before growing
+
+		key_equal m_equal;
+		hash m_hash;
+		f32 m_max_load_factor = 0.875f;
+
+		[[no_unique_address]] detail::allocator_reference<allocator_type> m_allocator;
+	};
+
+	template<
+		typename key,
+		typename hash = hash<key>,
+		typename key_equal = std::equal_to<>,
+		allocator alloc = heap_allocator
+	>
+	using flat_set = flat_map<key, void, hash, key_equal, alloc>;
+
+	template<typename k, typename v, typename h, typename e, typename a>
+	struct is_trivially_relocatable<flat_map<k, v, h, e, a>>
+		: __bool_constant<is_trivially_relocatable_v<h> && is_trivially_relocatable_v<e>> {};
+} // namespace utility
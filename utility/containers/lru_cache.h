@@ -0,0 +1,357 @@
+#pragma once
+#include "utility/containers/map.h"
+
+#include <functional>
+
+namespace utility {
+	/**
+	 * \brief Determines which entry a full cache evicts.
+	 */
+	enum class cache_policy {
+		lru,  // least recently used entry, every hit moves the entry to the front of a list
+		clock // second chance, a hit only sets a flag which the eviction sweep clears
+	};
+
+	struct cache_statistics {
+		u64 hits;
+		u64 misses;
+		u64 insertions;
+		u64 evictions; // entries removed to make room, explicit erase() calls are not counted
+	};
+
+	/**
+	 * \brief Bounded key-value cache. Entries live in a dense array which is indexed by a map, the cache holds
+	 * at most \b capacity entries and, optionally, a budget of user-defined bytes. Lookups, insertions and
+	 * evictions are O(1). Not thread-safe, including the statistics counters.
+	 * \tparam key Type to use as a key type
+	 * \tparam value Type to use as the value type
+	 * \tparam policy Eviction policy, clock avoids relinking the recency list on every hit
+	 * \tparam hash Hash to use when hashing the key type
+	 * \tparam key_equal Key equality operator
+	 * \tparam alloc Allocator used for the entries and the index
+	 */
+	template<
+		typename key,
+		typename value,
+		cache_policy policy = cache_policy::lru,
+		typename hash = hash<key>,
+		typename key_equal = std::equal_to<>,
+		allocator alloc = heap_allocator
+	>
+	class lru_cache {
+		static constexpr u32 invalid_index = limits<u32>::max();
+
+		struct entry {
+			template<typename value_type>
+			entry(const key& k, value_type&& v, u64 bytes)
+				: m_key(k), m_value(utility::forward<value_type>(v)), m_bytes(bytes), m_prev(invalid_index), m_next(invalid_index), m_referenced(false) {}
+
+			key m_key;
+			value m_value;
+			u64 m_bytes;
+			u32 m_prev; // towards the most recently used entry (lru only)
+			u32 m_next; // towards the least recently used entry (lru only)
+			bool m_referenced; // clock only
+		};
+	public:
+		using element_type = value;
+		using key_type = key;
+		using allocator_type = alloc;
+		using eviction_callback = std::function<void(const key_type&, value&)>;
+
+		/**
+		 * \brief Creates a cache which holds at most \b capacity entries whose combined size (see put()) does
+		 * not exceed \b byte_budget.
+		 */
+		lru_cache(u64 capacity, u64 byte_budget = limits<u64>::max())
+			: m_capacity(capacity), m_byte_budget(byte_budget) {
+			ASSERT(capacity > 0 && capacity < invalid_index, "invalid cache capacity\n");
+		}
+
+		lru_cache(u64 capacity, u64 byte_budget, allocator_type& allocator)
+			: m_entries(allocator), m_index(allocator), m_capacity(capacity), m_byte_budget(byte_budget) {
+			ASSERT(capacity > 0 && capacity < invalid_index, "invalid cache capacity\n");
+		}
+
+		/**
+		 * \brief Sets a function which is invoked with every entry before it is evicted.
+		 */
+		void set_eviction_callback(eviction_callback callback) {
+			m_on_evict = utility::move(callback);
+		}
+
+		/**
+		 * \brief Looks up \b k and marks it as recently used.
+		 * \return Pointer to the cached value, nullptr on a miss. Valid until the next modification.
+		 */
+		[[nodiscard]] auto get(const key_type& k) -> value* {
+			const auto it = m_index.find(k);
+
+			if(it == m_index.end()) {
+				++m_statistics.misses;
+				return nullptr;
+			}
+
+			++m_statistics.hits;
+			touch(it->second);
+
+			return &m_entries[it->second].m_value;
+		}
+
+		/**
+		 * \brief Looks up \b k without affecting the eviction order or the statistics.
+		 */
+		[[nodiscard]] auto peek(const key_type& k) const -> const value* {
+			const auto it = m_index.find(k);
+			return it == m_index.end() ? nullptr : &m_entries[it->second].m_value;
+		}
+
+		[[nodiscard]] auto contains(const key_type& k) const -> bool {
+			return m_index.contains(k);
+		}
+
+		/**
+		 * \brief Inserts or replaces the value of \b k and marks it as recently used. Evicts entries until both
+		 * the capacity and the byte budget are satisfied.
+		 * \param bytes Size charged against the byte budget
+		 * \return False if the value alone exceeds the byte budget, in which case nothing is cached.
+		 */
+		template<typename value_type>
+		auto put(const key_type& k, value_type&& v, u64 bytes = 0) -> bool {
+			if(bytes > m_byte_budget) {
+				erase(k);
+				return false;
+			}
+
+			++m_statistics.insertions;
+
+			const auto it = m_index.find(k);
+			u32 index;
+
+			if(it != m_index.end()) {
+				index = it->second;
+
+				entry& e = m_entries[index];
+				e.m_value = utility::forward<value_type>(v);
+				m_bytes = m_bytes - e.m_bytes + bytes;
+				e.m_bytes = bytes;
+
+				touch(index);
+			}
+			else if(m_entries.get_size() >= m_capacity) {
+				// a full cache reuses the slot of the victim, which saves moving another entry into the gap
+				index = select_victim(invalid_index);
+				notify_eviction(index);
+
+				entry& e = m_entries[index];
+				m_index.erase(e.m_key);
+				m_bytes = m_bytes - e.m_bytes + bytes;
+
+				e.m_key = k;
+				e.m_value = utility::forward<value_type>(v);
+				e.m_bytes = bytes;
+				e.m_referenced = false;
+
+				m_index.insert({ k, index });
+
+				if constexpr(policy == cache_policy::lru) {
+					unlink(index);
+					link_front(index);
+				}
+			}
+			else {
+				index = static_cast<u32>(m_entries.get_size());
+				m_entries.emplace_back(k, utility::forward<value_type>(v), bytes);
+				m_index.insert({ k, index });
+				m_bytes += bytes;
+
+				if constexpr(policy == cache_policy::lru) {
+					link_front(index);
+				}
+			}
+
+			// the entry which was just put is the last eviction candidate
+			while(m_bytes > m_byte_budget) {
+				index = evict(index);
+			}
+
+			return true;
+		}
+
+		/**
+		 * \brief Removes \b k without invoking the eviction callback.
+		 * \return Number of removed entries (0 or 1).
+		 */
+		auto erase(const key_type& k) -> u64 {
+			const auto it = m_index.find(k);
+
+			if(it == m_index.end()) {
+				return 0;
+			}
+
+			remove(it->second);
+			return 1;
+		}
+
+		void clear() {
+			m_entries.clear();
+			m_index.clear();
+
+			m_head = invalid_index;
+			m_tail = invalid_index;
+			m_hand = 0;
+			m_bytes = 0;
+		}
+
+		[[nodiscard]] auto get_statistics() const -> const cache_statistics& {
+			return m_statistics;
+		}
+		void reset_statistics() {
+			m_statistics = {};
+		}
+
+		[[nodiscard]] auto get_size() const -> u64 {
+			return m_entries.get_size();
+		}
+		[[nodiscard]] auto is_empty() const -> bool {
+			return m_entries.is_empty();
+		}
+		[[nodiscard]] auto get_capacity() const -> u64 {
+			return m_capacity;
+		}
+		[[nodiscard]] auto get_bytes() const -> u64 {
+			return m_bytes;
+		}
+		[[nodiscard]] auto get_byte_budget() const -> u64 {
+			return m_byte_budget;
+		}
+	protected:
+		void touch(u32 index) {
+			if constexpr(policy == cache_policy::lru) {
+				if(index != m_head) {
+					unlink(index);
+					link_front(index);
+				}
+			}
+			else {
+				m_entries[index].m_referenced = true;
+			}
+		}
+
+		// returns the next entry to evict, which is never \b keep
+		auto select_victim(u32 keep) -> u32 {
+			if constexpr(policy == cache_policy::lru) {
+				ASSERT(m_tail != keep, "cannot evict the entry which is being inserted\n");
+				return m_tail;
+			}
+			else {
+				// clear reference flags until an unreferenced entry comes up, at most one full sweep
+				while(true) {
+					if(m_hand >= m_entries.get_size()) {
+						m_hand = 0;
+					}
+
+					entry& e = m_entries[m_hand];
+
+					// the hand moves past the victim, otherwise the entry which replaces it would be the next victim
+					if(!e.m_referenced && m_hand != keep) {
+						return m_hand++;
+					}
+
+					e.m_referenced = false;
+					++m_hand;
+				}
+			}
+		}
+
+		void notify_eviction(u32 index) {
+			if(m_on_evict) {
+				entry& e = m_entries[index];
+				m_on_evict(e.m_key, e.m_value);
+			}
+
+			++m_statistics.evictions;
+		}
+
+		// evicts one entry, returns the (possibly relocated) index of the entry at \b keep
+		auto evict(u32 keep) -> u32 {
+			const u32 victim = select_victim(keep);
+			const u32 last = static_cast<u32>(m_entries.get_size() - 1);
+
+			notify_eviction(victim);
+			remove(victim);
+
+			return keep == last ? victim : keep;
+		}
+
+		// removes the entry at index, the last entry is moved into its place to keep the array dense
+		void remove(u32 index) {
+			const u32 last = static_cast<u32>(m_entries.get_size() - 1);
+
+			if constexpr(policy == cache_policy::lru) {
+				unlink(index);
+			}
+
+			m_bytes -= m_entries[index].m_bytes;
+			m_index.erase(m_entries[index].m_key);
+
+			if(index != last) {
+				m_entries[index] = utility::move(m_entries[last]);
+				m_index[m_entries[index].m_key] = index;
+
+				if constexpr(policy == cache_policy::lru) {
+					relink(index);
+				}
+			}
+
+			// destroyed in place, popping would move the entry out only to discard it
+			utility::destroy_at(&m_entries[last]);
+			m_entries.set_size(last);
+		}
+
+		void link_front(u32 index) {
+			entry& e = m_entries[index];
+
+			e.m_prev = invalid_index;
+			e.m_next = m_head;
+
+			if(m_head != invalid_index) {
+				m_entries[m_head].m_prev = index;
+			}
+			else {
+				m_tail = index;
+			}
+
+			m_head = index;
+		}
+
+		void unlink(u32 index) {
+			const entry& e = m_entries[index];
+
+			(e.m_prev != invalid_index ? m_entries[e.m_prev].m_next : m_head) = e.m_next;
+			(e.m_next != invalid_index ? m_entries[e.m_next].m_prev : m_tail) = e.m_prev;
+		}
+
+		// points the neighbours of an entry which was moved to \b index at its new position
+		void relink(u32 index) {
+			const entry& e = m_entries[index];
+
+			(e.m_prev != invalid_index ? m_entries[e.m_prev].m_next : m_head) = index;
+			(e.m_next != invalid_index ? m_entries[e.m_next].m_prev : m_tail) = index;
+		}
+	protected:
+		dynamic_array<entry, u64, alloc> m_entries;
+		map<key, u32, hash, key_equal, alloc> m_index; // key -> index into m_entries
+
+		u32 m_head = invalid_index; // most recently used entry (lru only)
+		u32 m_tail = invalid_index; // least recently used entry (lru only)
+		u32 m_hand = 0;             // next entry the eviction sweep looks at (clock only)
+
+		u64 m_capacity;
+		u64 m_byte_budget;
+		u64 m_bytes = 0;
+
+		eviction_callback m_on_evict;
+		cache_statistics m_statistics = {};
+	};
+} // namespace utility
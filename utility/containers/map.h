@@ -8,15 +8,53 @@ namespace utility {
 	template <typename mapped>
 	constexpr bool is_map_v = !is_void_v<mapped>;
 
+	namespace detail {
+		// lookups may use any key type which the hash and the equality operator accept
+		template<typename hash, typename key_equal>
+		concept transparent_lookup = requires {
+			typename hash::is_transparent;
+			typename key_equal::is_transparent;
+		};
+	} // namespace detail
+
+	template<typename key, typename value, typename hash, typename key_equal>
+	class map_image;
+
+	/**
+	 * \brief Snapshot of the bucket layout of a map, see map::get_statistics().
+	 */
+	struct map_statistics {
+		static constexpr u64 histogram_size = 16;
+
+		u64 size;
+		u64 bucket_count;
+		f32 load_factor;
+		u64 probe_histogram[histogram_size]; // [i] = values found after i + 1 probes, the last entry collects the rest
+		u64 max_probe_length;
+		f32 average_probe_length;            // probes of a successful lookup, 1 is optimal
+		f32 fingerprint_collision_rate;      // fraction of probes which compared the key of a different value
+		u64 bucket_bytes;
+		u64 value_bytes;
+	};
+
 	/**
 	 * \brief Hash-based unordered map. Maps a \b key to a specific \b value.
 	 * \tparam key Type to use as a key type
 	 * \tparam value Type to use as the value type
 	 * \tparam hash Hash to use when hashing the key type. A hash operator ("()") has to be implemented in order for the
 	 * map to work correctly. Some basic hash operators are provided by default. 
-	 * \tparam key_equal Key equality operator. Uses std::equal by default. 
+	 * \tparam key_equal Key equality operator. Uses std::equal_to<> by default. If both the hash and the
+	 * equality operator declare an is_transparent type, find(), contains(), at(), operator[], try_emplace()
+	 * and erase() accept any key type they support (ie. a string_view for dynamic_string keys).
+	 * \tparam alloc Allocator used for both the values and the buckets.
 	 */
-	template<typename key, typename value, typename hash = hash<key>, typename key_equal = std::equal_to<key>>
+	template<
+		typename key,
+		typename value,
+		typename hash = hash<key>,
+		typename key_equal = std::equal_to<>,
+		allocator alloc = heap_allocator
+	>
 	class map {
 		struct bucket {
 			static constexpr u32 dist_inc = 1U << 8U;             // skip 1 byte fingerprint
@@ -25,9 +63,13 @@ namespace utility {
 			u32 m_dist_and_fingerprint;                           // upper 3 byte: distance to original bucket. lower byte: fingerprint from hash
 			u32 m_value_idx;                                      // index into the m_values vector.
 		};
+
+		// serializes the buckets and values as they are, see map_image.h
+		template<typename, typename, typename, typename>
+		friend class map_image;
 	public:
 		using bucket_type = typename std::conditional_t<is_map_v<value>, std::pair<key, value>, key>;
-		using bucket_container_type = dynamic_array<bucket_type>;
+		using bucket_container_type = dynamic_array<bucket_type, u64, alloc>;
 
 		using const_iterator = typename bucket_container_type::const_iterator;
 		using iterator = typename bucket_container_type::iterator;
@@ -36,18 +78,20 @@ namespace utility {
 		using value_idx_type = decltype(bucket::m_value_idx);
 		using element_type = value;
 		using key_type = key;
+		using allocator_type = alloc;
+
+		// keeps heterogeneous overloads from hijacking the iterator overloads
+		template<typename K>
+		static constexpr bool is_iterator = std::is_convertible_v<K, iterator> || std::is_convertible_v<K, const_iterator>;
 
 		map() : map(0) {}
 
-		map(u64 bucket_count) : m_buckets(nullptr), m_num_buckets(0), m_max_bucket_capacity(0) {
-			if(bucket_count != 0) {
-				reserve(bucket_count);
-			}
-			else {
-				allocate_buckets_from_shift();
-				clear_buckets();
-			}
-		}
+		map(allocator_type& allocator) : map(0, allocator) {}
+
+		map(u64 bucket_count) : map(bucket_count, detail::allocator_reference<allocator_type>()) {}
+
+		map(u64 bucket_count, allocator_type& allocator)
+			: map(bucket_count, detail::allocator_reference<allocator_type>(allocator)) {}
 
 		map(initializer_list<bucket_type> ilist, u64 bucket_count = 0)
 			: map(bucket_count) {
@@ -57,26 +101,29 @@ namespace utility {
 		}
 
 		map(const map& other)
-		: m_values(other.m_values), m_equal(other.m_equal), m_hash(other.m_hash) {
+		: m_values(other.m_values), m_equal(other.m_equal), m_hash(other.m_hash), m_rehash_step(other.m_rehash_step), m_allocator(other.m_allocator) {
 			copy_buckets(other);
 		}
 
-		map(map&& other) noexcept : m_buckets(nullptr) {
+		map(map&& other) noexcept : m_buckets(nullptr), m_num_buckets(0) {
 			*this = utility::move(other);
 		}
 
 		~map() {
-			utility::free(m_buckets);
+			deallocate_buckets();
+			deallocate_old_buckets();
 		}
 
 		auto operator=(const map& other) -> map& {
 			if(&other != this) {
 				deallocate_buckets();
+				deallocate_old_buckets();
 
 				m_values = other.m_values;
 				m_hash = other.m_hash;
 				m_equal = other.m_equal;
 				m_shifts = initial_shifts;
+				m_rehash_step = other.m_rehash_step;
 
 				copy_buckets(other);
 			}
@@ -87,15 +134,22 @@ namespace utility {
 		auto operator=(map&& other) noexcept -> map& {
 			if(&other != this) {
 				deallocate_buckets();
+				deallocate_old_buckets();
 
 				m_values = utility::move(other.m_values);
 				other.m_values.clear();
+				m_allocator = other.m_allocator;
 				m_buckets = exchange(other.m_buckets, nullptr);
 				m_num_buckets = exchange(other.m_num_buckets, 0);
 				m_max_bucket_capacity = exchange(other.m_max_bucket_capacity, 0);
 				m_shifts = exchange(other.m_shifts, initial_shifts);
 				m_hash = exchange(other.m_hash, {});
 				m_equal = exchange(other.m_equal, {});
+				m_old_buckets = exchange(other.m_old_buckets, nullptr);
+				m_old_num_buckets = exchange(other.m_old_num_buckets, 0);
+				m_old_shifts = other.m_old_shifts;
+				m_rehash_position = exchange(other.m_rehash_position, 0);
+				m_rehash_step = other.m_rehash_step;
 
 				other.allocate_buckets_from_shift();
 				other.clear_buckets();
@@ -114,15 +168,33 @@ namespace utility {
 			return try_emplace(move(k)).first->second;
 		}
 
+		template <typename K, typename q = value, enable_if_t<is_map_v<q>, bool> = true>
+			requires detail::transparent_lookup<hash, key_equal>
+		auto operator[](K&& k) -> q& {
+			return do_try_emplace(utility::forward<K>(k)).first->second;
+		}
+
 		template <typename q = value, enable_if_t<is_map_v<q>, bool> = true>
 		[[nodiscard]] auto at(const key_type& k) -> const q& {
 			return do_at(k);
 		}
 
+		template <typename K, typename q = value, enable_if_t<is_map_v<q>, bool> = true>
+			requires detail::transparent_lookup<hash, key_equal>
+		[[nodiscard]] auto at(const K& k) -> const q& {
+			return do_at(k);
+		}
+
 		auto contains(const key_type& k) const -> bool {
 			return find(k) != end();
 		}
 
+		template<typename K>
+			requires detail::transparent_lookup<hash, key_equal>
+		auto contains(const K& k) const -> bool {
+			return find(k) != end();
+		}
+
 		auto insert(bucket_type const& v) -> std::pair<iterator, bool> {
 			return emplace(v);
     }
@@ -135,6 +207,53 @@ namespace utility {
 			return do_find(k);
 		}
 
+		template<typename K>
+			requires detail::transparent_lookup<hash, key_equal>
+		[[nodiscard]] auto find(const K& k) const -> const_iterator {
+			return do_find(k);
+		}
+
+		/**
+		 * \brief Looks up \b count keys at once, the iterator of keys[i] (or end()) is written to out[i].
+		 * Keys are processed in groups: all keys of a group are hashed and their buckets prefetched before
+		 * any probe is resolved, and values are prefetched before they are compared, so that the cache
+		 * misses of independent lookups overlap instead of being serialized.
+		 */
+		template<typename K>
+			requires std::is_same_v<K, key_type> || detail::transparent_lookup<hash, key_equal>
+		void find_batch(const K* keys, u64 count, const_iterator* out) const {
+			do_find_batch(keys, count, [&](u64 index, const_iterator it) {
+				out[index] = it;
+			});
+		}
+
+		/**
+		 * \brief Checks whether \b count keys are contained in the map, see find_batch().
+		 */
+		template<typename K>
+			requires std::is_same_v<K, key_type> || detail::transparent_lookup<hash, key_equal>
+		void contains_batch(const K* keys, u64 count, bool* out) const {
+			do_find_batch(keys, count, [&](u64 index, const_iterator it) {
+				out[index] = it != end();
+			});
+		}
+
+		template <typename q = value, typename... Args, enable_if_t<is_map_v<q>, bool> = true>
+		auto try_emplace(const key_type& k, Args&&... args) -> std::pair<iterator, bool> {
+			return do_try_emplace(k, utility::forward<Args>(args)...);
+		}
+
+		template <typename q = value, typename... Args, enable_if_t<is_map_v<q>, bool> = true>
+		auto try_emplace(key_type&& k, Args&&... args) -> std::pair<iterator, bool> {
+			return do_try_emplace(utility::move(k), utility::forward<Args>(args)...);
+		}
+
+		template <typename K, typename q = value, typename... Args, enable_if_t<is_map_v<q>, bool> = true>
+			requires detail::transparent_lookup<hash, key_equal> && (!is_iterator<K>)
+		auto try_emplace(K&& k, Args&&... args) -> std::pair<iterator, bool> {
+			return do_try_emplace(utility::forward<K>(k), utility::forward<Args>(args)...);
+		}
+
 		template<class... Args>
 		auto emplace(Args&&... args) -> std::pair<iterator, bool> {
 			auto& k = get_key(m_values.emplace_back(utility::forward<Args>(args)...));
@@ -158,6 +277,14 @@ namespace utility {
 				bucket_idx = next(bucket_idx);
 			}
 
+			if(m_old_buckets) {
+				if(const const_iterator it = do_find_in_old(k); it != end()) {
+					const u64 existing_idx = static_cast<u64>(it - begin());
+					m_values.pop_back();
+					return { begin() + existing_idx, false };
+				}
+			}
+
 			auto value_idx = static_cast<value_idx_type>(m_values.get_size() - 1);
 
 			if(is_full()) {
@@ -165,12 +292,66 @@ namespace utility {
 			}
 			else {
 				place_and_shift_up({ dist_and_fingerprint, value_idx }, bucket_idx);
+				migrate(m_rehash_step);
 			}
 
 			return { begin() + static_cast<u64>(value_idx), true };
 		}
 
+		/**
+		 * \brief Removes the element with the specified key, if it exists. Uses backward-shift deletion, so
+		 * no tombstones are left behind. The last element is moved into the vacated slot.
+		 * \return Number of removed elements (0 or 1).
+		 */
+		auto erase(const key_type& k) -> u64 {
+			return do_erase_key(k);
+		}
+
+		template<typename K>
+			requires detail::transparent_lookup<hash, key_equal> && (!is_iterator<K>)
+		auto erase(const K& k) -> u64 {
+			return do_erase_key(k);
+		}
+
+		/**
+		 * \brief Removes the element at \b it (ie. the result of find()), the last element is moved into
+		 * its slot.
+		 * \return Iterator to the element which now occupies the slot of the removed one.
+		 */
+		auto erase(const_iterator it) -> iterator {
+			const auto value_idx = static_cast<value_idx_type>(it - begin());
+
+			if(is_rehashing()) {
+				erase_during_rehash(value_idx);
+			}
+			else {
+				do_erase(find_bucket_of_value(value_idx));
+			}
+
+			return begin() + static_cast<u64>(value_idx);
+		}
+
+		/**
+		 * \brief Removes every element for which \b predicate returns true.
+		 * \return Number of removed elements.
+		 */
+		template<typename predicate_type>
+		auto erase_if(predicate_type&& predicate) -> u64 {
+			const u64 old_size = get_size();
+
+			// walk backwards, erasing moves the last element (which has already been visited) into the hole
+			for(u64 idx = old_size; idx > 0; --idx) {
+				if(predicate(m_values[idx - 1])) {
+					erase(begin() + (idx - 1));
+				}
+			}
+
+			return old_size - get_size();
+		}
+
 		void reserve(u64 capacity) {
+			complete_rehash();
+
 			capacity = min(capacity, max_size());
 			m_values.reserve(capacity);
 			const auto shifts = calc_shifts_for_size(max(capacity, get_size()));
@@ -218,18 +399,110 @@ namespace utility {
 			return m_values.is_empty();
 		}
 
+		/**
+		 * \brief Returns the number of bytes allocated by the map (buckets and values).
+		 */
+		[[nodiscard]] auto get_memory_usage() const -> u64 {
+			return m_values.get_memory_usage() + sizeof(bucket) * (m_num_buckets + m_old_num_buckets);
+		}
+
+		/**
+		 * \brief Collects probe length and fingerprint statistics, a degenerate hash shows up as long probe
+		 * sequences and a high collision rate. Makes a single pass over the buckets and doesn't allocate.
+		 * During an incremental rehash only the new bucket array is inspected, values which haven't been
+		 * migrated yet are missing from the histogram.
+		 */
+		[[nodiscard]] auto get_statistics() const -> map_statistics {
+			map_statistics stats{};
+
+			stats.size = get_size();
+			stats.bucket_count = m_num_buckets;
+			stats.load_factor = m_num_buckets ? static_cast<f32>(get_size()) / static_cast<f32>(m_num_buckets) : 0.0f;
+			stats.bucket_bytes = sizeof(bucket) * (m_num_buckets + m_old_num_buckets);
+			stats.value_bytes = m_values.get_memory_usage();
+
+			u64 values = 0;
+			u64 probes = 0;
+			u64 collisions = 0;
+
+			// a successful lookup of a value at distance d walks the d - 1 buckets in front of it, at step j it
+			// compares the packed distance and fingerprint (j + 1, fingerprint) against the bucket and only
+			// compares keys on a match, same as do_find()
+			for(u64 bucket_idx = 0; bucket_idx < m_num_buckets; ++bucket_idx) {
+				const dist_and_fingerprint_type dist_and_fingerprint = m_buckets[bucket_idx].m_dist_and_fingerprint;
+
+				if(dist_and_fingerprint == 0) {
+					continue;
+				}
+
+				const u64 distance = dist_and_fingerprint / bucket::dist_inc;
+
+				++stats.probe_histogram[min(distance, map_statistics::histogram_size) - 1];
+				stats.max_probe_length = max(stats.max_probe_length, distance);
+				probes += distance;
+				++values;
+
+				for(u64 i = 1; i < distance; ++i) {
+					const bucket& previous = m_buckets[(bucket_idx + m_num_buckets - i) & (m_num_buckets - 1)];
+					collisions += previous.m_dist_and_fingerprint == dist_and_fingerprint - i * bucket::dist_inc;
+				}
+			}
+
+			if(values > 0) {
+				stats.average_probe_length = static_cast<f32>(probes) / static_cast<f32>(values);
+				stats.fingerprint_collision_rate = static_cast<f32>(collisions) / static_cast<f32>(probes);
+			}
+
+			return stats;
+		}
+
 		void clear() {
 			m_values.clear();
 			clear_buckets();
+			deallocate_old_buckets();
+		}
+
+		/**
+		 * \brief Enables incremental rehashing. Instead of rebuilding the entire bucket array inside a single
+		 * insertion, growing keeps the old array around and every following insertion or erasure migrates
+		 * \b entries_per_operation values into the new one. Lookups consult both arrays until the migration
+		 * completes. Passing 0 disables the mode (and completes a pending migration).
+		 */
+		void set_incremental_rehash(u64 entries_per_operation) {
+			m_rehash_step = entries_per_operation;
+
+			if(m_rehash_step == 0) {
+				complete_rehash();
+			}
+		}
+
+		/**
+		 * \brief Checks whether an incremental migration into a new bucket array is in progress.
+		 */
+		[[nodiscard]] auto is_rehashing() const -> bool {
+			return m_old_buckets != nullptr;
+		}
+
+		/**
+		 * \brief Migrates all remaining values of a pending incremental rehash.
+		 */
+		void complete_rehash() {
+			migrate(limits<u64>::max());
 		}
 	protected:
-		template <class... Args>
-		auto try_emplace(const key_type& k, Args&&... args) -> std::pair<iterator, bool> {
-			return do_try_emplace(k, utility::forward<Args>(args)...);
-		}	
+		map(u64 bucket_count, const detail::allocator_reference<allocator_type>& allocator)
+			: m_values(allocator.get()), m_buckets(nullptr), m_num_buckets(0), m_max_bucket_capacity(0), m_allocator(allocator) {
+			if(bucket_count != 0) {
+				reserve(bucket_count);
+			}
+			else {
+				allocate_buckets_from_shift();
+				clear_buckets();
+			}
+		}
 
-		template <typename q = value, enable_if_t<is_map_v<q>, bool> = true>
-		auto do_at(const key_type& k) -> const q& {
+		template <typename K, typename q = value, enable_if_t<is_map_v<q>, bool> = true>
+		auto do_at(const K& k) -> const q& {
 			if(auto it = find(k); (end() != it)) {
 				return it->second;
 			}
@@ -255,6 +528,12 @@ namespace utility {
 					}
 				}
 				else if(dist_and_fingerprint > b->m_dist_and_fingerprint) {
+					if(m_old_buckets) {
+						if(const const_iterator it = do_find_in_old(k); it != end()) {
+							return { begin() + static_cast<u64>(it - begin()), false };
+						}
+					}
+
 					return do_place_element(
 						dist_and_fingerprint,
 						bucket_idx,
@@ -279,12 +558,14 @@ namespace utility {
 			}
 			else {
 				place_and_shift_up({ dist_and_fingerprint, value_idx }, bucket_idx);
+				migrate(m_rehash_step);
 			}
 
 			return { begin() + static_cast<u64>(value_idx), true };
 		}
 
-		auto do_find(const key& k) const -> const_iterator {
+		template<typename K>
+		auto do_find(const K& k) const -> const_iterator {
 			if(is_empty()) {
 				return end();
 			}
@@ -317,7 +598,7 @@ namespace utility {
 					}
 				}
 				else if(dist_and_fingerprint > b->m_dist_and_fingerprint) {
-					return end();
+					return m_old_buckets ? do_find_in_old(k) : end();
 				}
 
 				dist_and_fingerprint = dist_inc(dist_and_fingerprint);
@@ -326,6 +607,270 @@ namespace utility {
 			}
 		}
 
+		template<typename K>
+		auto do_erase_key(const K& k) -> u64 {
+			if(is_empty()) {
+				return 0;
+			}
+
+			if(is_rehashing()) {
+				const const_iterator it = do_find(k);
+
+				if(it == end()) {
+					return 0;
+				}
+
+				erase_during_rehash(static_cast<value_idx_type>(it - begin()));
+				return 1;
+			}
+
+			auto [dist_and_fingerprint, bucket_idx] = next_while_less(k);
+
+			while(
+				dist_and_fingerprint == at(m_buckets, bucket_idx).m_dist_and_fingerprint &&
+				!m_equal(k, get_key(m_values[at(m_buckets, bucket_idx).m_value_idx]))
+			) {
+				dist_and_fingerprint = dist_inc(dist_and_fingerprint);
+				bucket_idx = next(bucket_idx);
+			}
+
+			if(dist_and_fingerprint != at(m_buckets, bucket_idx).m_dist_and_fingerprint) {
+				return 0;
+			}
+
+			do_erase(bucket_idx);
+			return 1;
+		}
+
+		void do_erase(value_idx_type bucket_idx) {
+			const value_idx_type value_idx_to_remove = at(m_buckets, bucket_idx).m_value_idx;
+			remove_bucket(m_buckets, m_num_buckets, bucket_idx);
+
+			// the last value is about to be moved into the hole, redirect its bucket
+			const auto last_value_idx = static_cast<value_idx_type>(m_values.get_size() - 1);
+
+			if(value_idx_to_remove != last_value_idx) {
+				at(m_buckets, find_bucket_of_value(last_value_idx)).m_value_idx = value_idx_to_remove;
+			}
+
+			m_values.erase_unordered(m_values.begin() + value_idx_to_remove);
+		}
+
+		[[nodiscard]] auto find_bucket_of_value(value_idx_type value_idx) const -> value_idx_type {
+			value_idx_type bucket_idx = bucket_idx_from_hash(mixed_hash(get_key(m_values[value_idx])));
+
+			while(at(m_buckets, bucket_idx).m_value_idx != value_idx) {
+				bucket_idx = next(bucket_idx);
+			}
+
+			return bucket_idx;
+		}
+
+		template<typename K, typename function>
+		void do_find_batch(const K* keys, u64 count, function&& store) const {
+			if(is_empty()) {
+				for(u64 i = 0; i < count; ++i) {
+					store(i, end());
+				}
+
+				return;
+			}
+
+			bucket probes[batch_size];
+
+			for(u64 first = 0; first < count; first += batch_size) {
+				const u64 group_size = min(batch_size, count - first);
+
+				// hash every key of the group and prefetch its home bucket
+				for(u64 i = 0; i < group_size; ++i) {
+					const u64 h = mixed_hash(keys[first + i]);
+					probes[i] = { dist_and_fingerprint_from_hash(h), bucket_idx_from_hash(h) };
+					prefetch(m_buckets + probes[i].m_value_idx);
+				}
+
+				// advance to the first candidate bucket and prefetch its value
+				for(u64 i = 0; i < group_size; ++i) {
+					bucket& probe = probes[i];
+
+					while(probe.m_dist_and_fingerprint < at(m_buckets, probe.m_value_idx).m_dist_and_fingerprint) {
+						probe.m_dist_and_fingerprint = dist_inc(probe.m_dist_and_fingerprint);
+						probe.m_value_idx = next(probe.m_value_idx);
+					}
+
+					const bucket& b = at(m_buckets, probe.m_value_idx);
+
+					if(probe.m_dist_and_fingerprint == b.m_dist_and_fingerprint) {
+						prefetch(m_values.get_data() + b.m_value_idx);
+					}
+				}
+
+				// resolve the probes, the values should be in the cache by now
+				for(u64 i = 0; i < group_size; ++i) {
+					store(first + i, resolve_probe(keys[first + i], probes[i]));
+				}
+			}
+		}
+
+		// continues a lookup at probe, where probe.m_value_idx holds a bucket index
+		template<typename K>
+		auto resolve_probe(const K& k, bucket probe) const -> const_iterator {
+			while(true) {
+				const bucket& b = at(m_buckets, probe.m_value_idx);
+
+				if(probe.m_dist_and_fingerprint == b.m_dist_and_fingerprint) {
+					if(m_equal(k, get_key(m_values[b.m_value_idx]))) {
+						return begin() + static_cast<u64>(b.m_value_idx);
+					}
+				}
+				else if(probe.m_dist_and_fingerprint > b.m_dist_and_fingerprint) {
+					return m_old_buckets ? do_find_in_old(k) : end();
+				}
+
+				probe.m_dist_and_fingerprint = dist_inc(probe.m_dist_and_fingerprint);
+				probe.m_value_idx = next(probe.m_value_idx);
+			}
+		}
+
+		template<typename K>
+		auto do_find_in_old(const K& k) const -> const_iterator {
+			const u64 h = mixed_hash(k);
+			dist_and_fingerprint_type dist_and_fingerprint = dist_and_fingerprint_from_hash(h);
+			u64 bucket_idx = h >> m_old_shifts;
+
+			while(true) {
+				const bucket& b = m_old_buckets[bucket_idx];
+
+				if(dist_and_fingerprint == b.m_dist_and_fingerprint) {
+					if(m_equal(k, get_key(m_values[b.m_value_idx]))) {
+						return begin() + static_cast<u64>(b.m_value_idx);
+					}
+				}
+				else if(dist_and_fingerprint > b.m_dist_and_fingerprint) {
+					return end();
+				}
+
+				dist_and_fingerprint = dist_inc(dist_and_fingerprint);
+				bucket_idx = bucket_idx + 1 == m_old_num_buckets ? 0 : bucket_idx + 1;
+			}
+		}
+
+		// returns the bucket which refers to value_idx in the specified bucket array, nullptr if there is none
+		[[nodiscard]] auto locate_value(bucket* buckets, u64 num_buckets, u8 shifts, value_idx_type value_idx) const -> bucket* {
+			const u64 h = mixed_hash(get_key(m_values[value_idx]));
+			dist_and_fingerprint_type dist_and_fingerprint = dist_and_fingerprint_from_hash(h);
+			u64 bucket_idx = h >> shifts;
+
+			while(true) {
+				bucket& b = buckets[bucket_idx];
+
+				if(dist_and_fingerprint == b.m_dist_and_fingerprint && b.m_value_idx == value_idx) {
+					return &b;
+				}
+
+				if(dist_and_fingerprint > b.m_dist_and_fingerprint) {
+					return nullptr;
+				}
+
+				dist_and_fingerprint = dist_inc(dist_and_fingerprint);
+				bucket_idx = bucket_idx + 1 == num_buckets ? 0 : bucket_idx + 1;
+			}
+		}
+
+		// shifts the following buckets down until we find an empty one or one which is in its ideal slot
+		static void remove_bucket(bucket* buckets, u64 num_buckets, u64 bucket_idx) {
+			u64 next_bucket_idx = bucket_idx + 1 == num_buckets ? 0 : bucket_idx + 1;
+
+			while(buckets[next_bucket_idx].m_dist_and_fingerprint >= bucket::dist_inc * 2) {
+				buckets[bucket_idx] = {
+					dist_dec(buckets[next_bucket_idx].m_dist_and_fingerprint),
+					buckets[next_bucket_idx].m_value_idx
+				};
+
+				bucket_idx = exchange(next_bucket_idx, next_bucket_idx + 1 == num_buckets ? 0 : next_bucket_idx + 1);
+			}
+
+			buckets[bucket_idx] = {};
+		}
+
+		// the value may be referenced by either array (or both), see migrate()
+		void erase_during_rehash(value_idx_type value_idx) {
+			if(bucket* b = locate_value(m_buckets, m_num_buckets, m_shifts, value_idx)) {
+				remove_bucket(m_buckets, m_num_buckets, b - m_buckets);
+			}
+
+			if(bucket* b = locate_value(m_old_buckets, m_old_num_buckets, m_old_shifts, value_idx)) {
+				remove_bucket(m_old_buckets, m_old_num_buckets, b - m_old_buckets);
+			}
+
+			const auto last_value_idx = static_cast<value_idx_type>(m_values.get_size() - 1);
+
+			if(value_idx != last_value_idx) {
+				if(bucket* b = locate_value(m_buckets, m_num_buckets, m_shifts, last_value_idx)) {
+					b->m_value_idx = value_idx;
+				}
+
+				if(bucket* b = locate_value(m_old_buckets, m_old_num_buckets, m_old_shifts, last_value_idx)) {
+					b->m_value_idx = value_idx;
+				}
+			}
+
+			m_values.erase_unordered(m_values.begin() + value_idx);
+			m_rehash_position = min(m_rehash_position, static_cast<value_idx_type>(m_values.get_size()));
+
+			migrate(m_rehash_step);
+		}
+
+		// moves the old bucket array aside and starts filling a new one, twice as large
+		void start_rehash() {
+			m_old_buckets = exchange(m_buckets, nullptr);
+			m_old_num_buckets = m_num_buckets;
+			m_old_shifts = m_shifts--;
+
+			allocate_buckets_from_shift();
+			clear_buckets();
+
+			// the value which triggered the growth isn't in either array yet
+			const auto value_idx = static_cast<value_idx_type>(m_values.get_size() - 1);
+			auto [dist_and_fingerprint, b] = next_while_less(get_key(m_values[value_idx]));
+
+			place_and_shift_up({ dist_and_fingerprint, value_idx }, b);
+			m_rehash_position = value_idx;
+		}
+
+		/**
+		 * Values are migrated from the back: every value at or above m_rehash_position is referenced by
+		 * the new bucket array, values below it by at least one of the two arrays (erasure can move an
+		 * already migrated value below the position, which is why migration checks the new array first).
+		 */
+		void migrate(u64 count) {
+			if(!is_rehashing()) {
+				return;
+			}
+
+			for(; count > 0 && m_rehash_position > 0; --count) {
+				const value_idx_type value_idx = --m_rehash_position;
+
+				if(locate_value(m_buckets, m_num_buckets, m_shifts, value_idx) == nullptr) {
+					auto [dist_and_fingerprint, b] = next_while_less(get_key(m_values[value_idx]));
+					place_and_shift_up({ dist_and_fingerprint, value_idx }, b);
+				}
+			}
+
+			if(m_rehash_position == 0) {
+				deallocate_old_buckets();
+			}
+		}
+
+		void deallocate_old_buckets() {
+			if(m_old_buckets) {
+				m_allocator.get().deallocate(m_old_buckets, sizeof(bucket) * m_old_num_buckets);
+			}
+
+			m_old_buckets = nullptr;
+			m_old_num_buckets = 0;
+			m_rehash_position = 0;
+		}
+
 		[[nodiscard]] static constexpr auto at(bucket* bucket_ptr, u64 offset) -> bucket& {
 			return *(bucket_ptr + offset);
 		}
@@ -338,6 +883,14 @@ namespace utility {
 				return;
 			}
 
+			if(m_rehash_step > 0) {
+				// the previous migration has to finish before the next one can start
+				complete_rehash();
+				start_rehash();
+				migrate(m_rehash_step);
+				return;
+			}
+
 			--m_shifts;
 			deallocate_buckets();
 			allocate_buckets_from_shift();
@@ -345,7 +898,10 @@ namespace utility {
 		}
 
 		void deallocate_buckets() {
-			utility::free(m_buckets);
+			if(m_buckets) {
+				m_allocator.get().deallocate(m_buckets, sizeof(bucket) * m_num_buckets);
+			}
+
 			m_buckets = nullptr;
 
 			m_num_buckets = 0;
@@ -381,6 +937,10 @@ namespace utility {
 			return static_cast<dist_and_fingerprint_type>(x + bucket::dist_inc);
 		}
 
+		[[nodiscard]] static constexpr auto dist_dec(dist_and_fingerprint_type x) -> dist_and_fingerprint_type {
+			return static_cast<dist_and_fingerprint_type>(x - bucket::dist_inc);
+		}
+
 		[[nodiscard]] static constexpr auto get_key(const bucket_type& vt) -> const key_type& {
 			if constexpr (is_map_v<value>) {
 				return vt.first;
@@ -456,7 +1016,7 @@ namespace utility {
 
 		void allocate_buckets_from_shift() {
 			m_num_buckets = calc_num_buckets(m_shifts);
-			m_buckets = static_cast<bucket*>(utility::malloc(m_num_buckets * sizeof(bucket)));
+			m_buckets = static_cast<bucket*>(m_allocator.get().allocate(m_num_buckets * sizeof(bucket), alignof(bucket)));
 
 			if(m_num_buckets == max_bucket_count()) {
 				m_max_bucket_capacity = max_bucket_count();
@@ -471,6 +1031,12 @@ namespace utility {
 				allocate_buckets_from_shift();
 				clear_buckets();
 			}
+			else if(other.is_rehashing()) {
+				// the values are split between two arrays, rebuild a single one instead
+				m_shifts = other.m_shifts;
+				allocate_buckets_from_shift();
+				clear_and_fill_buckets_from_values();
+			}
 			else {
 				m_shifts = other.m_shifts;
 				allocate_buckets_from_shift();
@@ -479,6 +1045,7 @@ namespace utility {
 		}
 	protected:
 		static constexpr f32 default_max_load_factor = 0.8f;
+		static constexpr u64 batch_size = 16; // lookups in flight during find_batch()
 		static constexpr u8 initial_shifts = 64 - 2;
 
 		bucket_container_type m_values;
@@ -490,5 +1057,19 @@ namespace utility {
 		u64 m_num_buckets;
 		u64 m_max_bucket_capacity;
 		u8 m_shifts = initial_shifts;
+
+		// incremental rehashing, see migrate()
+		bucket* m_old_buckets = nullptr;
+		u64 m_old_num_buckets = 0;
+		u8 m_old_shifts = 0;
+		value_idx_type m_rehash_position = 0;
+		u64 m_rehash_step = 0;
+
+		[[no_unique_address]] detail::allocator_reference<allocator_type> m_allocator;
 	};
+
+	// buckets and values are only referenced through pointers, the functors decide the rest
+	template<typename k, typename v, typename h, typename e, typename a>
+	struct is_trivially_relocatable<map<k, v, h, e, a>>
+		: __bool_constant<is_trivially_relocatable_v<h> && is_trivially_relocatable_v<e>> {};
 } // namespace utility
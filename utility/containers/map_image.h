@@ -0,0 +1,378 @@
+#pragma once
+#include "utility/containers/map.h"
+#include "utility/system/filepath.h"
+#include "utility/result.h"
+
+#ifdef SYSTEM_LINUX
+#include <fcntl.h>
+#include <sys/mman.h>
+#endif
+
+namespace utility {
+	namespace detail {
+		struct map_image_header {
+			static constexpr u64 expected_magic = 0x50414d4c49545500; // "\0UTILMAP"
+			static constexpr u32 current_version = 1;
+
+			u64 magic;
+			u32 version;
+			u32 shifts;
+			u64 key_size;
+			u64 value_size;      // 0 for sets
+			u64 bucket_size;
+			u64 hash_check;      // combined hash of a few keys, detects images written with a different hash
+			u64 size;
+			u64 num_buckets;
+			u64 values_offset;
+			u64 buckets_offset;
+			u64 file_size;
+		};
+	} // namespace detail
+
+	/**
+	 * \brief Read-only view of a map which was written to a file via map_image::write(). The file is mapped
+	 * into memory and lookups run directly on the mapped values and buckets, opening an image neither
+	 * rehashes nor copies anything, pages are only loaded once they are touched.
+	 * Keys and values have to be trivially copyable, images can only be read on the platform which wrote them.
+	 * \tparam key Type to use as a key type
+	 * \tparam value Type to use as the value type, void for sets
+	 * \tparam hash Hash to use when hashing the key type, has to match the hash the image was written with
+	 * \tparam key_equal Key equality operator, lookups are transparent if both functors are
+	 */
+	template<
+		typename key,
+		typename value,
+		typename hash = hash<key>,
+		typename key_equal = std::equal_to<>
+	>
+	class map_image {
+		static_assert(std::is_trivially_copyable_v<key>, "map images require trivially copyable keys");
+
+		using header = detail::map_image_header;
+		using bucket = typename map<key, value, hash, key_equal>::bucket;
+
+		static constexpr u64 section_alignment = 64;
+		static constexpr u64 hash_check_samples = 8;
+	public:
+		using bucket_type = typename map<key, value, hash, key_equal>::bucket_type;
+		using const_iterator = const bucket_type*;
+
+		using element_type = value;
+		using key_type = key;
+
+		map_image() = default;
+
+		map_image(const map_image& other) = delete;
+		map_image(map_image&& other) noexcept {
+			*this = utility::move(other);
+		}
+
+		~map_image() {
+			close();
+		}
+
+		map_image& operator=(const map_image& other) = delete;
+		map_image& operator=(map_image&& other) noexcept {
+			if(&other != this) {
+				close();
+
+				m_memory = exchange(other.m_memory, nullptr);
+				m_memory_size = exchange(other.m_memory_size, 0);
+				m_values = exchange(other.m_values, nullptr);
+				m_buckets = exchange(other.m_buckets, nullptr);
+				m_size = exchange(other.m_size, 0);
+				m_num_buckets = exchange(other.m_num_buckets, 0);
+				m_shifts = other.m_shifts;
+			}
+
+			return *this;
+		}
+
+		/**
+		 * \brief Writes the values and buckets of \b source to \b path as they are laid out in memory.
+		 */
+		template<allocator alloc>
+		static auto write(const filepath& path, const map<key, value, hash, key_equal, alloc>& source) -> result<void> {
+			if(source.is_rehashing()) {
+				return error("cannot write a map image while an incremental rehash is pending");
+			}
+
+			header h{};
+
+			h.magic = header::expected_magic;
+			h.version = header::current_version;
+			h.shifts = source.m_shifts;
+			h.key_size = sizeof(key);
+			h.value_size = get_value_size();
+			h.bucket_size = sizeof(bucket_type);
+			h.hash_check = calc_hash_check(source.m_hash, source.m_values.get_data(), source.get_size());
+			h.size = source.get_size();
+			h.num_buckets = source.m_num_buckets;
+			h.values_offset = align_up(sizeof(header), section_alignment);
+			h.buckets_offset = align_up(h.values_offset + h.size * sizeof(bucket_type), section_alignment);
+			h.file_size = h.buckets_offset + h.num_buckets * sizeof(bucket);
+
+			FILE* file = fopen(path.get_data(), "wb");
+
+			if(file == nullptr) {
+				return error("failed to open map image for writing");
+			}
+
+			const bool success =
+				write_section(file, &h, sizeof(header), 0) &&
+				write_section(file, source.m_values.get_data(), h.size * sizeof(bucket_type), h.values_offset - sizeof(header)) &&
+				write_section(file, source.m_buckets, h.num_buckets * sizeof(bucket), h.buckets_offset - h.values_offset - h.size * sizeof(bucket_type));
+
+			if(fclose(file) != 0 || !success) {
+				return error("failed to write map image");
+			}
+
+			return {};
+		}
+
+		/**
+		 * \brief Maps the image at \b path into memory, fails if the file wasn't written by a map with the
+		 * same key, value and hash types.
+		 */
+		static auto open(const filepath& path) -> result<map_image> {
+			map_image image;
+
+			if(!image.map_file(path)) {
+				return error("failed to map image file");
+			}
+
+			if(image.m_memory_size < sizeof(header)) {
+				return error("map image is truncated");
+			}
+
+			const header& h = *static_cast<const header*>(image.m_memory);
+
+			if(h.magic != header::expected_magic || h.version != header::current_version) {
+				return error("incompatible map image version");
+			}
+
+			if(h.key_size != sizeof(key) || h.value_size != get_value_size() || h.bucket_size != sizeof(bucket_type)) {
+				return error("map image was written with different key or value types");
+			}
+
+			if(
+				h.file_size != image.m_memory_size ||
+				h.values_offset + h.size * sizeof(bucket_type) > h.buckets_offset ||
+				h.buckets_offset + h.num_buckets * sizeof(bucket) > h.file_size ||
+				h.shifts == 0 || h.shifts >= 64 || h.num_buckets != u64{ 1 } << (64 - h.shifts)
+			) {
+				return error("map image is corrupted");
+			}
+
+			image.m_values = reinterpret_cast<const bucket_type*>(static_cast<const u8*>(image.m_memory) + h.values_offset);
+			image.m_buckets = reinterpret_cast<const bucket*>(static_cast<const u8*>(image.m_memory) + h.buckets_offset);
+			image.m_size = h.size;
+			image.m_num_buckets = h.num_buckets;
+			image.m_shifts = static_cast<u8>(h.shifts);
+
+			if(calc_hash_check(image.m_hash, image.m_values, image.m_size) != h.hash_check) {
+				return error("map image was written with a different hash");
+			}
+
+			return image;
+		}
+
+		[[nodiscard]] auto find(const key_type& k) const -> const_iterator {
+			return do_find(k);
+		}
+
+		template<typename K>
+			requires detail::transparent_lookup<hash, key_equal>
+		[[nodiscard]] auto find(const K& k) const -> const_iterator {
+			return do_find(k);
+		}
+
+		[[nodiscard]] auto contains(const key_type& k) const -> bool {
+			return do_find(k) != end();
+		}
+
+		template<typename K>
+			requires detail::transparent_lookup<hash, key_equal>
+		[[nodiscard]] auto contains(const K& k) const -> bool {
+			return do_find(k) != end();
+		}
+
+		template <typename q = value, enable_if_t<is_map_v<q>, bool> = true>
+		[[nodiscard]] auto at(const key_type& k) const -> const q& {
+			const const_iterator it = do_find(k);
+			ASSERT(it != end(), "key not found\n");
+
+			return it->second;
+		}
+
+		[[nodiscard]] auto begin() const -> const_iterator { return m_values; }
+		[[nodiscard]] auto end() const -> const_iterator { return m_values + m_size; }
+
+		[[nodiscard]] auto get_size() const -> u64 {
+			return m_size;
+		}
+		[[nodiscard]] auto is_empty() const -> bool {
+			return m_size == 0;
+		}
+		[[nodiscard]] auto is_open() const -> bool {
+			return m_memory != nullptr;
+		}
+	protected:
+		[[nodiscard]] static constexpr auto align_up(u64 offset, u64 alignment) -> u64 {
+			return (offset + alignment - 1) & ~(alignment - 1);
+		}
+
+		[[nodiscard]] static constexpr auto get_value_size() -> u64 {
+			if constexpr(is_map_v<value>) {
+				static_assert(std::is_trivially_copyable_v<value>, "map images require trivially copyable values");
+				return sizeof(value);
+			}
+			else {
+				return 0;
+			}
+		}
+
+		[[nodiscard]] static constexpr auto get_key(const bucket_type& vt) -> const key_type& {
+			if constexpr(is_map_v<value>) {
+				return vt.first;
+			}
+			else {
+				return vt;
+			}
+		}
+
+		template<typename K>
+		[[nodiscard]] auto mixed_hash(const K& k) const -> u64 {
+			return compute_hash(m_hash(k));
+		}
+
+		// hashes a few keys spread across the values
+		[[nodiscard]] static auto calc_hash_check(const hash& h, const bucket_type* values, u64 size) -> u64 {
+			const u64 sample_count = min(size, hash_check_samples);
+			u64 check = 0;
+
+			for(u64 i = 0; i < sample_count; ++i) {
+				check = compute_hash(check ^ static_cast<u64>(h(get_key(values[i * (size / sample_count)]))));
+			}
+
+			return check;
+		}
+
+		// writes padding zero bytes followed by size bytes of data
+		static auto write_section(FILE* file, const void* data, u64 size, u64 padding) -> bool {
+			static constexpr u8 zeros[section_alignment] = {};
+			return fwrite(zeros, 1, padding, file) == padding && (size == 0 || fwrite(data, 1, size, file) == size);
+		}
+
+		// mirrors map::do_find(), the buckets are laid out exactly like in the map which wrote them; the
+		// buckets aren't validated by open() (that would touch every page), so a corrupted image must not
+		// index past the values or probe forever
+		template<typename K>
+		auto do_find(const K& k) const -> const_iterator {
+			if(m_size == 0) {
+				return end();
+			}
+
+			const u64 h = mixed_hash(k);
+			u32 dist_and_fingerprint = bucket::dist_inc | (static_cast<u32>(h) & bucket::fingerprint_mask);
+			u64 bucket_idx = h >> m_shifts;
+
+			for(u64 probe = 0; probe < m_num_buckets; ++probe) {
+				const bucket& b = m_buckets[bucket_idx];
+
+				if(dist_and_fingerprint == b.m_dist_and_fingerprint) {
+					if(b.m_value_idx >= m_size) {
+						return end();
+					}
+
+					if(m_equal(k, get_key(m_values[b.m_value_idx]))) {
+						return m_values + b.m_value_idx;
+					}
+				}
+				else if(dist_and_fingerprint > b.m_dist_and_fingerprint) {
+					return end();
+				}
+
+				dist_and_fingerprint += bucket::dist_inc;
+				bucket_idx = bucket_idx + 1 == m_num_buckets ? 0 : bucket_idx + 1;
+			}
+
+			return end();
+		}
+
+		auto map_file(const filepath& path) -> bool {
+#ifdef SYSTEM_WINDOWS
+			HANDLE file = CreateFileA(path.get_data(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+			if(file == INVALID_HANDLE_VALUE) {
+				return false;
+			}
+
+			LARGE_INTEGER size;
+			HANDLE mapping = nullptr;
+
+			if(GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+				mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			}
+
+			// the view keeps the mapping alive, both handles can be closed right away
+			if(mapping) {
+				m_memory = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+				m_memory_size = static_cast<u64>(size.QuadPart);
+				CloseHandle(mapping);
+			}
+
+			CloseHandle(file);
+#else
+			const int fd = ::open(path.get_data(), O_RDONLY);
+
+			if(fd < 0) {
+				return false;
+			}
+
+			struct stat info;
+
+			if(fstat(fd, &info) == 0 && info.st_size > 0) {
+				void* memory = mmap(nullptr, static_cast<u64>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+				if(memory != MAP_FAILED) {
+					m_memory = memory;
+					m_memory_size = static_cast<u64>(info.st_size);
+				}
+			}
+
+			// the mapping keeps its own reference to the file
+			::close(fd);
+#endif
+
+			return m_memory != nullptr;
+		}
+
+		void close() {
+			if(m_memory == nullptr) {
+				return;
+			}
+
+#ifdef SYSTEM_WINDOWS
+			UnmapViewOfFile(m_memory);
+#else
+			munmap(const_cast<void*>(m_memory), m_memory_size);
+#endif
+
+			m_memory = nullptr;
+			m_memory_size = 0;
+		}
+	protected:
+		const void* m_memory = nullptr;
+		u64 m_memory_size = 0;
+
+		const bucket_type* m_values = nullptr;
+		const bucket* m_buckets = nullptr;
+		u64 m_size = 0;
+		u64 m_num_buckets = 0;
+		u8 m_shifts = 0;
+
+		[[no_unique_address]] key_equal m_equal;
+		[[no_unique_address]] hash m_hash;
+	};
+} // namespace utility
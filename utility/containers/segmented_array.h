@@ -0,0 +1,274 @@
+#pragma once
+#include "utility/containers/dynamic_array.h"
+
+#include <bit>
+
+namespace utility {
+	/**
+	 * \brief Growable array which stores its elements in fixed-size chunks. Growing appends a new chunk
+	 * instead of relocating the existing elements, which means that pointers and references to elements
+	 * stay valid until the element is removed.
+	 * \tparam value Type of the stored elements
+	 * \tparam chunk_size Number of elements per chunk, has to be a power of two
+	 * \tparam alloc Allocator used for the chunks and the chunk table
+	 */
+	template<typename value, u64 chunk_size = 256, allocator alloc = heap_allocator>
+	class segmented_array {
+		static_assert(chunk_size > 0 && (chunk_size & (chunk_size - 1)) == 0, "chunk size has to be a power of two");
+
+		static constexpr u64 chunk_shift = std::bit_width(chunk_size) - 1;
+		static constexpr u64 chunk_mask = chunk_size - 1;
+	public:
+		using element_type = value;
+		using size_type = u64;
+		using allocator_type = alloc;
+
+		template<typename type>
+		class iterator_base {
+		public:
+			iterator_base() = default;
+			iterator_base(element_type* const* chunks, size_type index) : m_chunks(chunks), m_index(index) {}
+
+			[[nodiscard]] auto operator*() const -> type& {
+				return m_chunks[m_index >> chunk_shift][m_index & chunk_mask];
+			}
+			[[nodiscard]] auto operator->() const -> type* {
+				return &**this;
+			}
+
+			auto operator++() -> iterator_base& {
+				++m_index;
+				return *this;
+			}
+			auto operator--() -> iterator_base& {
+				--m_index;
+				return *this;
+			}
+			auto operator+=(i64 offset) -> iterator_base& {
+				m_index += offset;
+				return *this;
+			}
+
+			[[nodiscard]] auto operator+(i64 offset) const -> iterator_base {
+				return { m_chunks, m_index + offset };
+			}
+			[[nodiscard]] auto operator-(const iterator_base& other) const -> i64 {
+				return static_cast<i64>(m_index) - static_cast<i64>(other.m_index);
+			}
+
+			[[nodiscard]] auto operator==(const iterator_base& other) const -> bool {
+				return m_index == other.m_index;
+			}
+			[[nodiscard]] auto operator!=(const iterator_base& other) const -> bool {
+				return m_index != other.m_index;
+			}
+		private:
+			element_type* const* m_chunks = nullptr;
+			size_type m_index = 0;
+		};
+
+		using const_iterator = iterator_base<const element_type>;
+		using iterator = iterator_base<element_type>;
+
+		segmented_array() : m_size(0) {}
+		segmented_array(allocator_type& allocator) : m_chunks(allocator), m_size(0), m_allocator(allocator) {}
+		segmented_array(initializer_list<element_type> i_list) : segmented_array() {
+			reserve(i_list.size());
+
+			for(const element_type& v : i_list) {
+				utility::construct_at(get_slot(m_size++), v);
+			}
+		}
+		segmented_array(const segmented_array& other)
+			: m_chunks(other.m_allocator.get()), m_size(0), m_allocator(other.m_allocator) {
+			copy_from(other);
+		}
+		segmented_array(segmented_array&& other) noexcept
+			: m_chunks(utility::move(other.m_chunks)), m_size(exchange(other.m_size, 0)), m_allocator(other.m_allocator) {}
+
+		~segmented_array() {
+			clear();
+			deallocate_chunks();
+		}
+
+		void push_back(const element_type& v) {
+			utility::construct_at(get_next_slot(), v);
+			++m_size;
+		}
+
+		template<typename... Args>
+		auto emplace_back(Args&&... args) -> element_type& {
+			element_type* slot = utility::construct_at(get_next_slot(), utility::forward<Args>(args)...);
+			++m_size;
+			return *slot;
+		}
+
+		auto pop_back() -> element_type {
+			if(is_empty()) {
+				return {};
+			}
+
+			element_type* slot = get_slot(--m_size);
+			element_type result = utility::move(*slot);
+			utility::destroy_at(slot);
+
+			return result;
+		}
+
+		/**
+		 * \brief Ensures that \b capacity elements fit without allocating further chunks.
+		 */
+		void reserve(size_type capacity) {
+			while(get_capacity() < capacity) {
+				allocate_chunk();
+			}
+		}
+
+		/**
+		 * \brief Destroys all elements, chunks are kept and reused by subsequent insertions.
+		 */
+		void clear() {
+			if constexpr(!is_trivial_v<element_type>) {
+				for_each_chunk([](element_type* data, size_type count) {
+					utility::destruct_range(data, data + count);
+				});
+			}
+
+			m_size = 0;
+		}
+
+		/**
+		 * \brief Releases chunks which don't hold any elements.
+		 */
+		void shrink_to_fit() {
+			const size_type used_chunks = (m_size + chunk_mask) >> chunk_shift;
+
+			while(m_chunks.get_size() > used_chunks) {
+				m_allocator.get().deallocate(m_chunks.pop_back(), chunk_size * sizeof(element_type));
+			}
+		}
+
+		/**
+		 * \brief Invokes \b func with a pointer to the first element and the element count of every
+		 * non-empty chunk, in order. Faster than iterating element by element.
+		 */
+		template<typename function>
+		void for_each_chunk(function&& func) const {
+			size_type remaining = m_size;
+
+			for(size_type i = 0; remaining > 0; ++i) {
+				const size_type count = min(remaining, chunk_size);
+				func(m_chunks[i], count);
+				remaining -= count;
+			}
+		}
+
+		[[nodiscard]] auto is_empty() const -> bool {
+			return m_size == 0;
+		}
+
+		[[nodiscard]] auto get_first() const -> const element_type& {
+			return (*this)[0];
+		}
+		[[nodiscard]] auto get_last() const -> const element_type& {
+			return (*this)[m_size - 1];
+		}
+		[[nodiscard]] auto get_size() const -> size_type { return m_size; }
+		[[nodiscard]] auto get_capacity() const -> size_type { return m_chunks.get_size() * chunk_size; }
+		[[nodiscard]] auto get_chunk_count() const -> size_type { return m_chunks.get_size(); }
+		[[nodiscard]] static constexpr auto get_chunk_size() -> size_type { return chunk_size; }
+
+		[[nodiscard]] auto get_memory_usage() const -> u64 {
+			u64 usage = m_chunks.get_memory_usage() + get_capacity() * sizeof(element_type);
+
+			if constexpr(requires(const element_type& e) { e.get_memory_usage(); }) {
+				for(const element_type& element : *this) {
+					usage += element.get_memory_usage();
+				}
+			}
+
+			return usage;
+		}
+
+		[[nodiscard]] auto begin() -> iterator { return { m_chunks.get_data(), 0 }; }
+		[[nodiscard]] auto end() -> iterator { return { m_chunks.get_data(), m_size }; }
+		[[nodiscard]] auto begin() const -> const_iterator { return { m_chunks.get_data(), 0 }; }
+		[[nodiscard]] auto end() const -> const_iterator { return { m_chunks.get_data(), m_size }; }
+
+		auto operator=(const segmented_array& other) -> segmented_array& {
+			if(this != &other) {
+				clear();
+				copy_from(other);
+			}
+
+			return *this;
+		}
+		auto operator=(segmented_array&& other) noexcept -> segmented_array& {
+			if(this != &other) {
+				clear();
+				deallocate_chunks();
+
+				m_chunks = utility::move(other.m_chunks);
+				m_size = exchange(other.m_size, 0);
+				m_allocator = other.m_allocator;
+			}
+
+			return *this;
+		}
+		[[nodiscard]] auto operator[](size_type index) -> element_type& {
+			ASSERT(index < m_size, "index out of range");
+			return *get_slot(index);
+		}
+		[[nodiscard]] auto operator[](size_type index) const -> const element_type& {
+			ASSERT(index < m_size, "index out of range");
+			return *get_slot(index);
+		}
+	protected:
+		[[nodiscard]] auto get_slot(size_type index) const -> element_type* {
+			return m_chunks[index >> chunk_shift] + (index & chunk_mask);
+		}
+
+		[[nodiscard]] auto get_next_slot() -> element_type* {
+			if(m_size == get_capacity()) {
+				allocate_chunk();
+			}
+
+			return get_slot(m_size);
+		}
+
+		void allocate_chunk() {
+			element_type* chunk = static_cast<element_type*>(
+				m_allocator.get().allocate(chunk_size * sizeof(element_type), alignof(element_type))
+			);
+
+			ASSERT(chunk, "allocation failure");
+			m_chunks.push_back(chunk);
+		}
+
+		void deallocate_chunks() {
+			for(element_type* chunk : m_chunks) {
+				m_allocator.get().deallocate(chunk, chunk_size * sizeof(element_type));
+			}
+
+			m_chunks.clear();
+		}
+
+		void copy_from(const segmented_array& other) {
+			reserve(other.get_size());
+
+			other.for_each_chunk([this](const element_type* data, size_type count) {
+				for(size_type i = 0; i < count; ++i) {
+					utility::construct_at(get_slot(m_size++), data[i]);
+				}
+			});
+		}
+	protected:
+		dynamic_array<element_type*, u64, allocator_type> m_chunks;
+		size_type m_size;
+
+		[[no_unique_address]] detail::allocator_reference<allocator_type> m_allocator;
+	};
+
+	template<typename value, u64 chunk_size, typename alloc>
+	struct is_trivially_relocatable<segmented_array<value, chunk_size, alloc>> : true_type {};
+} // namespace utility
@@ -4,7 +4,12 @@
 #include "utility/containers/map.h"
 
 namespace utility {
-	template<typename key, typename hash = hash<key>, typename key_equal = std::equal_to<key>>
-	using set = map<key, void, hash, key_equal>;
+	template<
+		typename key,
+		typename hash = hash<key>,
+		typename key_equal = std::equal_to<>,
+		allocator alloc = heap_allocator
+	>
+	using set = map<key, void, hash, key_equal, alloc>;
 } // namespace utility
 
@@ -0,0 +1,267 @@
+#pragma once
+#include "utility/containers/dynamic_array.h"
+
+namespace utility {
+	/**
+	 * \brief Growable array with inline storage for \b count elements, the heap is only used once the
+	 * inline capacity is exceeded. Shares the interface of the dynamic array.
+	 * \tparam value Type of the stored elements
+	 * \tparam count Number of elements which fit into the inline storage
+	 * \tparam size Type used for sizes and indices
+	 * \tparam alloc Allocator used once the elements spill out of the inline storage
+	 */
+	template<typename value, u64 count, typename size = u64, allocator alloc = heap_allocator>
+	class small_array {
+		static_assert(count > 0, "small arrays need at least one inline element");
+	public:
+		using element_type = value;
+		using size_type = size;
+		using allocator_type = alloc;
+
+		using const_iterator = const element_type*;
+		using iterator = element_type*;
+
+		static constexpr size_type inline_capacity = count;
+
+		small_array() : m_data(get_inline_data()), m_capacity(inline_capacity), m_size(0) {}
+		small_array(allocator_type& allocator)
+			: m_data(get_inline_data()), m_capacity(inline_capacity), m_size(0), m_allocator(allocator) {}
+		small_array(initializer_list<element_type> i_list) : small_array() {
+			reserve(i_list.size());
+			utility::construct_range(m_data, i_list.begin(), i_list.end());
+
+			m_size = i_list.size();
+		}
+		small_array(size_type s, const element_type& v) : small_array() {
+			reserve(s);
+
+			for(size_type i = 0; i < s; ++i) {
+				utility::construct_at(m_data + i, v);
+			}
+
+			m_size = s;
+		}
+		small_array(const small_array& other)
+			: m_data(get_inline_data()), m_capacity(inline_capacity), m_size(0), m_allocator(other.m_allocator) {
+			reserve(other.get_size());
+			utility::construct_range(m_data, other.begin(), other.end());
+
+			m_size = other.get_size();
+		}
+		small_array(small_array&& other) noexcept
+			: m_data(get_inline_data()), m_capacity(inline_capacity), m_size(0), m_allocator(other.m_allocator) {
+			take(other);
+		}
+
+		~small_array() {
+			clear();
+			deallocate();
+		}
+
+		void push_back(const element_type& val) {
+			if(m_size >= m_capacity) {
+				reserve(m_capacity * 2);
+			}
+
+			utility::construct_at(m_data + m_size++, val);
+		}
+		auto pop_back() -> element_type {
+			if(is_empty()) {
+				return {};
+			}
+
+			--m_size;
+
+			element_type result = utility::move(m_data[m_size]);
+			utility::destroy_at(m_data + m_size);
+
+			return result;
+		}
+
+		template<typename... Args>
+		auto emplace_back(Args&&... args) -> element_type& {
+			if(m_size >= m_capacity) {
+				reserve(m_capacity * 2);
+			}
+
+			utility::construct_at(m_data + m_size, utility::forward<Args>(args)...);
+			return m_data[m_size++];
+		}
+
+		template<typename iterator_type>
+		void insert(iterator pos, iterator_type first, iterator_type last) {
+			if(first == last) {
+				return;
+			}
+
+			const size_type num_elements_to_insert = utility::distance(first, last);
+			const size_type index = static_cast<size_type>(pos - m_data);
+
+			// ensure there is enough space for the new elements
+			if(m_size + num_elements_to_insert > m_capacity) {
+				reserve(max(m_size + num_elements_to_insert, m_capacity * 2));
+			}
+
+			// move existing elements to make space for the new elements
+			if constexpr(is_trivially_relocatable_v<element_type>) {
+				utility::memmove(
+					m_data + index + num_elements_to_insert,
+					m_data + index,
+					(m_size - index) * sizeof(element_type)
+				);
+			}
+			else {
+				// move construct elements from end to start to prevent overwriting
+				for(size_type i = m_size; i > index; --i) {
+					utility::construct_at(m_data + i + num_elements_to_insert - 1, utility::move(m_data[i - 1]));
+					utility::destroy_at(m_data + i - 1);
+				}
+			}
+
+			// copy new elements into the space created
+			auto insert_pos = m_data + index;
+
+			for(auto it = first; it != last; ++it, ++insert_pos) {
+				utility::construct_at(insert_pos, *it);
+			}
+
+			m_size += num_elements_to_insert;
+		}
+
+		void reserve(size_type new_capacity) {
+			if(new_capacity <= m_capacity) {
+				return;
+			}
+
+			if(!is_small() && m_allocator.get().try_expand(m_data, m_capacity * sizeof(element_type), new_capacity * sizeof(element_type))) {
+				m_capacity = new_capacity;
+				return;
+			}
+
+			element_type* new_data = static_cast<element_type*>(
+				m_allocator.get().allocate(new_capacity * sizeof(element_type), alignof(element_type))
+			);
+
+			ASSERT(new_data, "allocation failure");
+			relocate(new_data);
+
+			deallocate();
+			m_data = new_data;
+			m_capacity = new_capacity;
+		}
+		void clear() {
+			if constexpr(!is_trivial_v<element_type>) {
+				utility::destruct_range(begin(), end());
+			}
+
+			m_size = 0;
+		}
+
+		[[nodiscard]] auto is_empty() const -> bool {
+			return m_size == 0;
+		}
+		/**
+		 * \brief Checks whether the elements are held in the inline storage.
+		 */
+		[[nodiscard]] auto is_small() const -> bool {
+			return m_data == get_inline_data();
+		}
+
+		[[nodiscard]] auto get_data() const -> element_type* {
+			return m_data;
+		}
+		[[nodiscard]] auto get_last() const -> const element_type& {
+			return m_data[m_size - 1];
+		}
+		[[nodiscard]] auto get_capacity() const -> size_type { return m_capacity; }
+		[[nodiscard]] auto get_size() const -> size_type { return m_size; }
+		void set_size(size_type s)  { m_size = s; }
+
+		[[nodiscard]] auto get_memory_usage() const -> u64 {
+			u64 usage = is_small() ? 0 : m_capacity * sizeof(element_type);
+
+			if constexpr(requires(const element_type& e) { e.get_memory_usage(); }) {
+				for(const element_type& element : *this) {
+					usage += element.get_memory_usage();
+				}
+			}
+
+			return usage;
+		}
+
+		[[nodiscard]] auto begin() -> iterator { return m_data; }
+		[[nodiscard]] auto end() -> iterator { return m_data + m_size; }
+		[[nodiscard]] auto begin() const -> const_iterator { return m_data; }
+		[[nodiscard]] auto end() const -> const_iterator { return m_data + m_size; }
+
+		auto operator=(const small_array& other) -> small_array& {
+			if(this != &other) {
+				clear();
+				reserve(other.get_size());
+				utility::construct_range(m_data, other.begin(), other.end());
+
+				m_size = other.get_size();
+			}
+
+			return *this;
+		}
+		auto operator=(small_array&& other) noexcept -> small_array& {
+			if(this != &other) {
+				clear();
+				deallocate();
+
+				m_data = get_inline_data();
+				m_capacity = inline_capacity;
+				m_allocator = other.m_allocator;
+
+				take(other);
+			}
+
+			return *this;
+		}
+		[[nodiscard]] auto operator[](size_type index) -> element_type& {
+			ASSERT(index < m_size, "index out of range");
+			return m_data[index];
+		}
+		[[nodiscard]] auto operator[](size_type index) const -> const element_type& {
+			ASSERT(index < m_size, "index out of range");
+			return m_data[index];
+		}
+	protected:
+		[[nodiscard]] auto get_inline_data() const -> element_type* {
+			return reinterpret_cast<element_type*>(const_cast<u8*>(m_storage));
+		}
+
+		// moves the elements into new_data and destroys the originals
+		void relocate(element_type* new_data) {
+			utility::relocate_range(new_data, m_data, m_size);
+		}
+
+		// takes over the contents of other, expects this array to be empty and small
+		void take(small_array& other) {
+			if(other.is_small()) {
+				// inline elements can't be stolen, move them one by one
+				utility::relocate_range(m_data, other.m_data, other.m_size);
+			}
+			else {
+				m_data = exchange(other.m_data, other.get_inline_data());
+				m_capacity = exchange(other.m_capacity, inline_capacity);
+			}
+
+			m_size = exchange(other.m_size, 0);
+		}
+
+		void deallocate() {
+			if(!is_small()) {
+				m_allocator.get().deallocate(m_data, m_capacity * sizeof(element_type));
+			}
+		}
+	protected:
+		element_type* m_data;
+		size_type m_capacity;
+		size_type m_size;
+
+		[[no_unique_address]] detail::allocator_reference<allocator_type> m_allocator;
+		alignas(element_type) u8 m_storage[sizeof(element_type) * count];
+	};
+} // namespace utility
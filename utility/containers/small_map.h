@@ -0,0 +1,447 @@
+#pragma once
+#include "utility/containers/map.h"
+
+namespace utility {
+	/**
+	 * \brief Map with inline storage for \b count elements. Small maps neither allocate nor hash, lookups
+	 * compare the key against every element. Once the inline storage overflows the elements move into a
+	 * regular map, which takes over the same memory. Shares the interface of the map, including the dense
+	 * value layout (iterators are pointers, erasing moves the last element into the gap).
+	 * \tparam key Type to use as a key type
+	 * \tparam value Type to use as the value type, void turns the map into a set
+	 * \tparam count Number of elements which fit into the inline storage
+	 * \tparam hash Hash used once the map outgrows the inline storage
+	 * \tparam key_equal Key equality operator, lookups are transparent if both functors are
+	 * \tparam alloc Allocator used once the map outgrows the inline storage
+	 */
+	template<
+		typename key,
+		typename value,
+		u64 count = 16,
+		typename hash = hash<key>,
+		typename key_equal = std::equal_to<>,
+		allocator alloc = heap_allocator
+	>
+	class small_map {
+		static_assert(count > 0, "small maps need at least one inline element");
+	public:
+		using map_type = map<key, value, hash, key_equal, alloc>;
+		using bucket_type = typename map_type::bucket_type;
+
+		using const_iterator = const bucket_type*;
+		using iterator = bucket_type*;
+
+		using element_type = value;
+		using key_type = key;
+		using allocator_type = alloc;
+
+		static constexpr u64 inline_capacity = count;
+
+		small_map() = default;
+		small_map(allocator_type& allocator) : m_allocator(allocator) {}
+		small_map(initializer_list<bucket_type> ilist) {
+			for(const auto& i : ilist) {
+				emplace(i);
+			}
+		}
+		small_map(const small_map& other) : m_allocator(other.m_allocator) {
+			copy(other);
+		}
+		small_map(small_map&& other) noexcept : m_allocator(other.m_allocator) {
+			take(other);
+		}
+
+		~small_map() {
+			destroy();
+		}
+
+		auto operator=(const small_map& other) -> small_map& {
+			if(&other != this) {
+				destroy();
+				copy(other);
+			}
+
+			return *this;
+		}
+		auto operator=(small_map&& other) noexcept -> small_map& {
+			if(&other != this) {
+				destroy();
+
+				m_allocator = other.m_allocator;
+				take(other);
+			}
+
+			return *this;
+		}
+
+		template <typename q = value, enable_if_t<is_map_v<q>, bool> = true>
+		auto operator[](const key_type& k) -> q& {
+			return do_try_emplace(k).first->second;
+		}
+
+		template <typename q = value, enable_if_t<is_map_v<q>, bool> = true>
+		auto operator[](key_type&& k) -> q& {
+			return do_try_emplace(utility::move(k)).first->second;
+		}
+
+		template <typename K, typename q = value, enable_if_t<is_map_v<q>, bool> = true>
+			requires detail::transparent_lookup<hash, key_equal>
+		auto operator[](K&& k) -> q& {
+			return do_try_emplace(utility::forward<K>(k)).first->second;
+		}
+
+		template <typename q = value, enable_if_t<is_map_v<q>, bool> = true>
+		[[nodiscard]] auto at(const key_type& k) const -> const q& {
+			const const_iterator it = find(k);
+			ASSERT(it != end(), "key not found\n");
+
+			return it->second;
+		}
+
+		template <typename K, typename q = value, enable_if_t<is_map_v<q>, bool> = true>
+			requires detail::transparent_lookup<hash, key_equal>
+		[[nodiscard]] auto at(const K& k) const -> const q& {
+			const const_iterator it = find(k);
+			ASSERT(it != end(), "key not found\n");
+
+			return it->second;
+		}
+
+		[[nodiscard]] auto contains(const key_type& k) const -> bool {
+			return find(k) != end();
+		}
+
+		template<typename K>
+			requires detail::transparent_lookup<hash, key_equal>
+		[[nodiscard]] auto contains(const K& k) const -> bool {
+			return find(k) != end();
+		}
+
+		[[nodiscard]] auto find(const key_type& k) const -> const_iterator {
+			return do_find(k);
+		}
+		[[nodiscard]] auto find(const key_type& k) -> iterator {
+			return const_cast<iterator>(do_find(k));
+		}
+
+		template<typename K>
+			requires detail::transparent_lookup<hash, key_equal>
+		[[nodiscard]] auto find(const K& k) const -> const_iterator {
+			return do_find(k);
+		}
+
+		template<typename K>
+			requires detail::transparent_lookup<hash, key_equal>
+		[[nodiscard]] auto find(const K& k) -> iterator {
+			return const_cast<iterator>(do_find(k));
+		}
+
+		auto insert(const bucket_type& v) -> std::pair<iterator, bool> {
+			return emplace(v);
+		}
+
+		auto insert(bucket_type&& v) -> std::pair<iterator, bool> {
+			return emplace(utility::move(v));
+		}
+
+		template<class... Args>
+		auto emplace(Args&&... args) -> std::pair<iterator, bool> {
+			if(is_large()) {
+				return get_map().emplace(utility::forward<Args>(args)...);
+			}
+
+			if(m_size < inline_capacity) {
+				// construct in place, the duplicate check needs the key
+				bucket_type* slot = get_inline_data() + m_size;
+				utility::construct_at(slot, utility::forward<Args>(args)...);
+
+				if(const const_iterator it = find_inline(get_key(*slot)); it != slot) {
+					utility::destroy_at(slot);
+					return { const_cast<iterator>(it), false };
+				}
+
+				return { get_inline_data() + m_size++, true };
+			}
+
+			bucket_type v(utility::forward<Args>(args)...);
+
+			if(const const_iterator it = find_inline(get_key(v)); it != end()) {
+				return { const_cast<iterator>(it), false };
+			}
+
+			grow();
+			return get_map().emplace(utility::move(v));
+		}
+
+		template <typename q = value, typename... Args, enable_if_t<is_map_v<q>, bool> = true>
+		auto try_emplace(const key_type& k, Args&&... args) -> std::pair<iterator, bool> {
+			return do_try_emplace(k, utility::forward<Args>(args)...);
+		}
+
+		template <typename q = value, typename... Args, enable_if_t<is_map_v<q>, bool> = true>
+		auto try_emplace(key_type&& k, Args&&... args) -> std::pair<iterator, bool> {
+			return do_try_emplace(utility::move(k), utility::forward<Args>(args)...);
+		}
+
+		template <typename K, typename q = value, typename... Args, enable_if_t<is_map_v<q>, bool> = true>
+			requires detail::transparent_lookup<hash, key_equal> && (!map_type::template is_iterator<K>)
+		auto try_emplace(K&& k, Args&&... args) -> std::pair<iterator, bool> {
+			return do_try_emplace(utility::forward<K>(k), utility::forward<Args>(args)...);
+		}
+
+		/**
+		 * \brief Removes the element with the specified key, if it exists. The last element is moved into the
+		 * vacated slot.
+		 * \return Number of removed elements (0 or 1).
+		 */
+		auto erase(const key_type& k) -> u64 {
+			return do_erase(k);
+		}
+
+		template<typename K>
+			requires detail::transparent_lookup<hash, key_equal> && (!map_type::template is_iterator<K>)
+		auto erase(const K& k) -> u64 {
+			return do_erase(k);
+		}
+
+		/**
+		 * \brief Removes the element at \b it (ie. the result of find()), the last element is moved into
+		 * its slot.
+		 * \return Iterator to the element which now occupies the slot of the removed one.
+		 */
+		auto erase(const_iterator it) -> iterator {
+			if(is_large()) {
+				return get_map().erase(it);
+			}
+
+			const iterator position = const_cast<iterator>(it);
+			bucket_type* last = get_inline_data() + --m_size;
+
+			if(position != last) {
+				*position = utility::move(*last);
+			}
+
+			utility::destroy_at(last);
+			return position;
+		}
+
+		/**
+		 * \brief Removes every element for which \b predicate returns true.
+		 * \return Number of removed elements.
+		 */
+		template<typename predicate_type>
+		auto erase_if(predicate_type&& predicate) -> u64 {
+			if(is_large()) {
+				return get_map().erase_if(utility::forward<predicate_type>(predicate));
+			}
+
+			const u64 old_size = m_size;
+
+			// walk backwards, erasing moves the last element (which has already been visited) into the hole
+			for(u64 idx = old_size; idx > 0; --idx) {
+				if(predicate(get_inline_data()[idx - 1])) {
+					erase(get_inline_data() + (idx - 1));
+				}
+			}
+
+			return old_size - m_size;
+		}
+
+		/**
+		 * \brief Removes all elements, a map which outgrew the inline storage keeps its buckets.
+		 */
+		void clear() {
+			if(is_large()) {
+				get_map().clear();
+			}
+			else {
+				if constexpr(!is_trivial_v<bucket_type>) {
+					utility::destruct_range(get_inline_data(), get_inline_data() + m_size);
+				}
+
+				m_size = 0;
+			}
+		}
+
+		void reserve(u64 capacity) {
+			if(capacity > inline_capacity) {
+				if(!is_large()) {
+					grow();
+				}
+
+				get_map().reserve(capacity);
+			}
+		}
+
+		[[nodiscard]] auto begin() -> iterator { return is_large() ? get_map().begin() : get_inline_data(); }
+		[[nodiscard]] auto begin() const -> const_iterator { return is_large() ? get_map().begin() : get_inline_data(); }
+		[[nodiscard]] auto end() -> iterator { return is_large() ? get_map().end() : get_inline_data() + m_size; }
+		[[nodiscard]] auto end() const -> const_iterator { return is_large() ? get_map().end() : get_inline_data() + m_size; }
+
+		[[nodiscard]] auto get_size() const -> u64 {
+			return is_large() ? get_map().get_size() : m_size;
+		}
+		[[nodiscard]] auto is_empty() const -> bool {
+			return get_size() == 0;
+		}
+		/**
+		 * \brief Checks whether the elements were moved into a hashed map.
+		 */
+		[[nodiscard]] auto is_large() const -> bool {
+			return m_size == large_size;
+		}
+
+		/**
+		 * \brief Returns the number of bytes allocated outside of the inline storage.
+		 */
+		[[nodiscard]] auto get_memory_usage() const -> u64 {
+			return is_large() ? get_map().get_memory_usage() : 0;
+		}
+	protected:
+		static constexpr u64 large_size = limits<u64>::max(); // m_size of a map which outgrew the inline storage
+		static constexpr u64 storage_size = max(sizeof(bucket_type) * count, sizeof(map_type));
+		static constexpr u64 storage_alignment = max(alignof(bucket_type), alignof(map_type));
+
+		[[nodiscard]] static constexpr auto get_key(const bucket_type& vt) -> const key_type& {
+			if constexpr(is_map_v<value>) {
+				return vt.first;
+			}
+			else {
+				return vt;
+			}
+		}
+
+		[[nodiscard]] auto get_inline_data() const -> bucket_type* {
+			return reinterpret_cast<bucket_type*>(const_cast<u8*>(m_storage));
+		}
+		[[nodiscard]] auto get_map() -> map_type& {
+			return *std::launder(reinterpret_cast<map_type*>(m_storage));
+		}
+		[[nodiscard]] auto get_map() const -> const map_type& {
+			return *std::launder(reinterpret_cast<const map_type*>(m_storage));
+		}
+
+		template<typename K>
+		[[nodiscard]] auto find_inline(const K& k) const -> const_iterator {
+			const bucket_type* data = get_inline_data();
+
+			for(u64 i = 0; i < m_size; ++i) {
+				if(m_equal(k, get_key(data[i]))) {
+					return data + i;
+				}
+			}
+
+			return data + m_size;
+		}
+
+		template<typename K>
+		auto do_find(const K& k) const -> const_iterator {
+			return is_large() ? get_map().find(k) : find_inline(k);
+		}
+
+		template<typename K>
+		auto do_erase(const K& k) -> u64 {
+			if(is_large()) {
+				return get_map().erase(k);
+			}
+
+			const const_iterator it = find_inline(k);
+
+			if(it == end()) {
+				return 0;
+			}
+
+			erase(it);
+			return 1;
+		}
+
+		template<typename K, typename... Args>
+		auto do_try_emplace(K&& k, Args&&... args) -> std::pair<iterator, bool> {
+			if(!is_large()) {
+				if(const const_iterator it = find_inline(k); it != end()) {
+					return { const_cast<iterator>(it), false };
+				}
+
+				if(m_size < inline_capacity) {
+					bucket_type* slot = get_inline_data() + m_size++;
+					utility::construct_at(slot, std::piecewise_construct, std::forward_as_tuple(utility::forward<K>(k)), std::forward_as_tuple(utility::forward<Args>(args)...));
+
+					return { slot, true };
+				}
+
+				grow();
+			}
+
+			return get_map().try_emplace(utility::forward<K>(k), utility::forward<Args>(args)...);
+		}
+
+		// moves the inline elements into a map which is constructed in the same storage
+		void grow() {
+			alignas(bucket_type) u8 buffer[sizeof(bucket_type) * count];
+			bucket_type* elements = reinterpret_cast<bucket_type*>(buffer);
+			const u64 size = m_size;
+
+			utility::relocate_range(elements, get_inline_data(), size);
+			utility::construct_at(reinterpret_cast<map_type*>(m_storage), inline_capacity * 2, m_allocator.get());
+			m_size = large_size;
+
+			map_type& large = get_map();
+
+			for(u64 i = 0; i < size; ++i) {
+				large.emplace(utility::move(elements[i]));
+				utility::destroy_at(elements + i);
+			}
+		}
+
+		void destroy() {
+			if(is_large()) {
+				utility::destroy_at(&get_map());
+				m_size = 0;
+			}
+			else {
+				clear();
+			}
+		}
+
+		// expects this map to be empty and small
+		void copy(const small_map& other) {
+			if(other.is_large()) {
+				utility::construct_at(reinterpret_cast<map_type*>(m_storage), other.get_map());
+				m_size = large_size;
+			}
+			else {
+				utility::construct_range(get_inline_data(), other.begin(), other.end());
+				m_size = other.m_size;
+			}
+		}
+
+		// expects this map to be empty and small
+		void take(small_map& other) {
+			if(other.is_large()) {
+				utility::construct_at(reinterpret_cast<map_type*>(m_storage), utility::move(other.get_map()));
+				m_size = large_size;
+
+				other.destroy();
+			}
+			else {
+				utility::relocate_range(get_inline_data(), other.get_inline_data(), other.m_size);
+				m_size = exchange(other.m_size, 0);
+			}
+		}
+	protected:
+		alignas(storage_alignment) u8 m_storage[storage_size];
+		u64 m_size = 0; // number of inline elements, large_size once the elements live in a map
+
+		[[no_unique_address]] key_equal m_equal;
+		[[no_unique_address]] detail::allocator_reference<allocator_type> m_allocator;
+	};
+
+	template<
+		typename key,
+		u64 count = 16,
+		typename hash = hash<key>,
+		typename key_equal = std::equal_to<>,
+		allocator alloc = heap_allocator
+	>
+	using small_set = small_map<key, void, count, hash, key_equal, alloc>;
+} // namespace utility
@@ -0,0 +1,319 @@
+#pragma once
+#include "utility/allocators/allocator_base.h"
+#include "utility/ranges.h"
+
+namespace utility {
+	namespace detail {
+		template<u64 index, typename type, typename... types>
+		struct type_at {
+			using element_type = typename type_at<index - 1, types...>::element_type;
+		};
+
+		template<typename type, typename... types>
+		struct type_at<0, type, types...> {
+			using element_type = type;
+		};
+
+		template<u64 index, typename... types>
+		using type_at_t = typename type_at<index, types...>::element_type;
+	} // namespace detail
+
+	/**
+	 * \brief Growable struct-of-arrays container. Every member type is stored in its own contiguous
+	 * column, columns are aligned to a cache line so that they can be fed directly into SIMD kernels.
+	 * Loops which only touch some of the members only pull those members into the cache.
+	 * \tparam alloc Allocator used for the column storage, all columns share a single allocation
+	 * \tparam types Types of the individual columns
+	 */
+	template<allocator alloc, typename... types>
+	class soa_array_base {
+		static_assert(sizeof...(types) > 0, "struct-of-arrays containers need at least one column");
+
+		static constexpr u64 column_count = sizeof...(types);
+		static constexpr u64 column_alignment = 64;
+
+		static_assert(((alignof(types) <= column_alignment) && ...), "unsupported column alignment");
+	public:
+		template<u64 index>
+		using column_type = detail::type_at_t<index, types...>;
+		using size_type = u64;
+		using allocator_type = alloc;
+
+		/**
+		 * \brief Proxy which refers to a single row of the array, members are accessed via get<I>().
+		 */
+		template<typename array_type>
+		class row_reference {
+		public:
+			row_reference(array_type* array, size_type index) : m_array(array), m_index(index) {}
+
+			template<u64 column>
+			[[nodiscard]] auto get() const -> decltype(auto) {
+				return m_array->template get_data<column>()[m_index];
+			}
+
+			[[nodiscard]] auto get_index() const -> size_type {
+				return m_index;
+			}
+		private:
+			array_type* m_array;
+			size_type m_index;
+		};
+
+		template<typename array_type>
+		class iterator_base {
+		public:
+			iterator_base(array_type* array, size_type index) : m_array(array), m_index(index) {}
+
+			[[nodiscard]] auto operator*() const -> row_reference<array_type> {
+				return { m_array, m_index };
+			}
+
+			auto operator++() -> iterator_base& {
+				++m_index;
+				return *this;
+			}
+			auto operator--() -> iterator_base& {
+				--m_index;
+				return *this;
+			}
+
+			[[nodiscard]] auto operator+(i64 offset) const -> iterator_base {
+				return { m_array, m_index + offset };
+			}
+			[[nodiscard]] auto operator-(const iterator_base& other) const -> i64 {
+				return static_cast<i64>(m_index) - static_cast<i64>(other.m_index);
+			}
+
+			[[nodiscard]] auto operator==(const iterator_base& other) const -> bool {
+				return m_index == other.m_index;
+			}
+			[[nodiscard]] auto operator!=(const iterator_base& other) const -> bool {
+				return m_index != other.m_index;
+			}
+		private:
+			array_type* m_array;
+			size_type m_index;
+		};
+
+		using const_iterator = iterator_base<const soa_array_base>;
+		using iterator = iterator_base<soa_array_base>;
+
+		soa_array_base() = default;
+		soa_array_base(allocator_type& allocator) : m_allocator(allocator) {}
+		soa_array_base(const soa_array_base& other) : m_allocator(other.m_allocator) {
+			copy_from(other);
+		}
+		soa_array_base(soa_array_base&& other) noexcept : m_allocator(other.m_allocator) {
+			take(other);
+		}
+
+		~soa_array_base() {
+			clear();
+			deallocate();
+		}
+
+		void push_back(const types&... values) {
+			emplace_back(values...);
+		}
+
+		/**
+		 * \brief Appends a row, every column is constructed from the corresponding argument.
+		 */
+		template<typename... Args>
+		auto emplace_back(Args&&... args) -> row_reference<soa_array_base> {
+			static_assert(sizeof...(Args) == column_count, "one value per column expected");
+
+			if(m_size >= m_capacity) {
+				reserve(m_capacity > 0 ? m_capacity * 2 : 1);
+			}
+
+			emplace_row(m_size, std::index_sequence_for<types...>{}, utility::forward<Args>(args)...);
+			return { this, m_size++ };
+		}
+
+		void pop_back() {
+			if(is_empty()) {
+				return;
+			}
+
+			--m_size;
+			for_each_column([this]<typename type>(type* column) {
+				utility::destroy_at(column + m_size);
+			});
+		}
+
+		void reserve(size_type new_capacity) {
+			if(new_capacity <= m_capacity) {
+				return;
+			}
+
+			void* columns[column_count];
+			void* memory = allocate_columns(new_capacity, columns);
+
+			relocate_columns(columns, std::index_sequence_for<types...>{});
+
+			deallocate();
+			m_memory = memory;
+			m_capacity = new_capacity;
+
+			for(u64 i = 0; i < column_count; ++i) {
+				m_columns[i] = columns[i];
+			}
+		}
+
+		void clear() {
+			for_each_column([this]<typename type>(type* column) {
+				if constexpr(!is_trivial_v<type>) {
+					utility::destruct_range(column, column + m_size);
+				}
+			});
+
+			m_size = 0;
+		}
+
+		/**
+		 * \brief Returns a pointer to the first element of the specified \b column, the column holds
+		 * get_size() elements and is aligned to a cache line.
+		 */
+		template<u64 column>
+		[[nodiscard]] auto get_data() -> column_type<column>* {
+			return static_cast<column_type<column>*>(m_columns[column]);
+		}
+		template<u64 column>
+		[[nodiscard]] auto get_data() const -> const column_type<column>* {
+			return static_cast<const column_type<column>*>(m_columns[column]);
+		}
+
+		template<u64 column>
+		[[nodiscard]] auto get(size_type index) -> column_type<column>& {
+			ASSERT(index < m_size, "index out of range");
+			return get_data<column>()[index];
+		}
+		template<u64 column>
+		[[nodiscard]] auto get(size_type index) const -> const column_type<column>& {
+			ASSERT(index < m_size, "index out of range");
+			return get_data<column>()[index];
+		}
+
+		[[nodiscard]] auto is_empty() const -> bool {
+			return m_size == 0;
+		}
+		[[nodiscard]] auto get_capacity() const -> size_type { return m_capacity; }
+		[[nodiscard]] auto get_size() const -> size_type { return m_size; }
+
+		[[nodiscard]] auto get_memory_usage() const -> u64 {
+			return m_memory ? get_allocation_size(m_capacity) : 0;
+		}
+
+		[[nodiscard]] auto begin() -> iterator { return { this, 0 }; }
+		[[nodiscard]] auto end() -> iterator { return { this, m_size }; }
+		[[nodiscard]] auto begin() const -> const_iterator { return { this, 0 }; }
+		[[nodiscard]] auto end() const -> const_iterator { return { this, m_size }; }
+
+		auto operator=(const soa_array_base& other) -> soa_array_base& {
+			if(this != &other) {
+				clear();
+				copy_from(other);
+			}
+
+			return *this;
+		}
+		auto operator=(soa_array_base&& other) noexcept -> soa_array_base& {
+			if(this != &other) {
+				clear();
+				deallocate();
+
+				m_allocator = other.m_allocator;
+				take(other);
+			}
+
+			return *this;
+		}
+		[[nodiscard]] auto operator[](size_type index) -> row_reference<soa_array_base> {
+			ASSERT(index < m_size, "index out of range");
+			return { this, index };
+		}
+		[[nodiscard]] auto operator[](size_type index) const -> row_reference<const soa_array_base> {
+			ASSERT(index < m_size, "index out of range");
+			return { this, index };
+		}
+	protected:
+		[[nodiscard]] static constexpr auto align_up(u64 value, u64 alignment) -> u64 {
+			return (value + alignment - 1) & ~(alignment - 1);
+		}
+
+		// the allocation is padded, the heap only guarantees alignof(max_align_t)
+		[[nodiscard]] static constexpr auto get_allocation_size(size_type capacity) -> u64 {
+			return (align_up(capacity * sizeof(types), column_alignment) + ...) + column_alignment;
+		}
+
+		[[nodiscard]] auto allocate_columns(size_type capacity, void* (&columns)[column_count]) -> void* {
+			void* memory = m_allocator.get().allocate(get_allocation_size(capacity), alignof(std::max_align_t));
+			ASSERT(memory, "allocation failure\n");
+
+			u8* position = reinterpret_cast<u8*>(align_up(reinterpret_cast<u64>(memory), column_alignment));
+			u64 index = 0;
+
+			((columns[index++] = position, position += align_up(capacity * sizeof(types), column_alignment)), ...);
+			return memory;
+		}
+
+		template<typename function>
+		void for_each_column(function&& func) {
+			u64 index = 0;
+			(func(static_cast<types*>(m_columns[index++])), ...);
+		}
+
+		template<u64... indices, typename... Args>
+		void emplace_row(size_type row, std::index_sequence<indices...>, Args&&... args) {
+			(utility::construct_at(get_data<indices>() + row, utility::forward<Args>(args)), ...);
+		}
+
+		template<u64... indices>
+		void relocate_columns(void* (&columns)[column_count], std::index_sequence<indices...>) {
+			(utility::relocate_range(static_cast<column_type<indices>*>(columns[indices]), get_data<indices>(), m_size), ...);
+		}
+
+		template<u64... indices>
+		void copy_columns(const soa_array_base& other, std::index_sequence<indices...>) {
+			(utility::construct_range(get_data<indices>(), other.get_data<indices>(), other.get_data<indices>() + other.m_size), ...);
+		}
+
+		void copy_from(const soa_array_base& other) {
+			reserve(other.m_size);
+			copy_columns(other, std::index_sequence_for<types...>{});
+			m_size = other.m_size;
+		}
+
+		void take(soa_array_base& other) {
+			m_memory = exchange(other.m_memory, nullptr);
+			m_capacity = exchange(other.m_capacity, 0);
+			m_size = exchange(other.m_size, 0);
+
+			for(u64 i = 0; i < column_count; ++i) {
+				m_columns[i] = exchange(other.m_columns[i], nullptr);
+			}
+		}
+
+		void deallocate() {
+			if(m_memory) {
+				m_allocator.get().deallocate(m_memory, get_allocation_size(m_capacity));
+			}
+		}
+	protected:
+		void* m_memory = nullptr;
+		void* m_columns[column_count] = {};
+
+		size_type m_capacity = 0;
+		size_type m_size = 0;
+
+		[[no_unique_address]] detail::allocator_reference<allocator_type> m_allocator;
+	};
+
+	template<typename... types>
+	using soa_array = soa_array_base<heap_allocator, types...>;
+
+	template<typename alloc, typename... types>
+	struct is_trivially_relocatable<soa_array_base<alloc, types...>> : true_type {};
+} // namespace utility
@@ -0,0 +1,250 @@
+#pragma once
+#include "utility/containers/map.h"
+
+#include <bit>
+
+namespace utility {
+	namespace detail {
+		// intentionally not constexpr, reaching it during constant evaluation turns into a compile error
+		inline void static_map_error(const char* message) {
+			ASSERT(false, "{}\n", message);
+			(void)message;
+		}
+	} // namespace detail
+
+	/**
+	 * \brief Immutable hash map whose layout is computed at compile time. Construction searches for a
+	 * perfect hash (every key gets its own slot): keys are split into small buckets and every bucket gets a
+	 * pilot value which displaces its keys into free slots. A lookup is one hash, one pilot and slot read and
+	 * a single key comparison, there is no probing, no heap and, for constexpr instances, no startup cost.
+	 * \tparam key Type to use as a key type, string keys can use string_view_base<const char, u64>
+	 * \tparam value Type to use as the value type, void turns the map into a set
+	 * \tparam count Number of entries
+	 * \tparam hash Hash to use when hashing the key type, has to be usable in constant expressions
+	 * \tparam key_equal Key equality operator, lookups are transparent if both functors are
+	 */
+	template<
+		typename key,
+		typename value,
+		u64 count,
+		typename hash = hash<key>,
+		typename key_equal = std::equal_to<>
+	>
+	class static_map {
+		static_assert(count > 0, "static maps need at least one entry");
+		static_assert(count <= limits<u32>::max(), "too many entries");
+
+		// slots are kept at most 80% full, this keeps the pilot search short
+		static constexpr u64 slot_count = std::bit_ceil(count + count / 4);
+		static constexpr u64 slot_mask = slot_count - 1;
+
+		// two keys per bucket on average
+		static constexpr u64 bucket_count = max(std::bit_ceil(count) / 2, u64{ 1 });
+		static constexpr u64 bucket_mask = bucket_count - 1;
+
+		// with at most 80% of the slots taken a bucket usually needs a handful of attempts, exhausting the
+		// pilots takes a hash which maps different keys to (nearly) the same values
+		static constexpr u32 max_pilot = 1 << 16;
+	public:
+		using bucket_type = typename std::conditional_t<is_map_v<value>, std::pair<key, value>, key>;
+		using const_iterator = const bucket_type*;
+
+		using element_type = value;
+		using key_type = key;
+
+		constexpr static_map(const bucket_type (&entries)[count])
+			: static_map(entries, std::make_index_sequence<count>{}) {}
+
+		[[nodiscard]] constexpr auto find(const key_type& k) const -> const_iterator {
+			return do_find(k);
+		}
+
+		template<typename K>
+			requires detail::transparent_lookup<hash, key_equal>
+		[[nodiscard]] constexpr auto find(const K& k) const -> const_iterator {
+			return do_find(k);
+		}
+
+		[[nodiscard]] constexpr auto contains(const key_type& k) const -> bool {
+			return do_find(k) != end();
+		}
+
+		template<typename K>
+			requires detail::transparent_lookup<hash, key_equal>
+		[[nodiscard]] constexpr auto contains(const K& k) const -> bool {
+			return do_find(k) != end();
+		}
+
+		template <typename q = value, enable_if_t<is_map_v<q>, bool> = true>
+		[[nodiscard]] constexpr auto at(const key_type& k) const -> const q& {
+			const const_iterator it = do_find(k);
+			ASSERT(it != end(), "key not found\n");
+
+			return it->second;
+		}
+
+		template <typename K, typename q = value, enable_if_t<is_map_v<q>, bool> = true>
+			requires detail::transparent_lookup<hash, key_equal>
+		[[nodiscard]] constexpr auto at(const K& k) const -> const q& {
+			const const_iterator it = do_find(k);
+			ASSERT(it != end(), "key not found\n");
+
+			return it->second;
+		}
+
+		[[nodiscard]] constexpr auto begin() const -> const_iterator { return m_entries; }
+		[[nodiscard]] constexpr auto end() const -> const_iterator { return m_entries + count; }
+
+		[[nodiscard]] static constexpr auto get_size() -> u64 {
+			return count;
+		}
+		[[nodiscard]] static constexpr auto get_slot_count() -> u64 {
+			return slot_count;
+		}
+	protected:
+		template<u64... indices>
+		constexpr static_map(const bucket_type (&entries)[count], std::index_sequence<indices...>)
+			: m_entries{ entries[indices]... } {
+			build();
+		}
+
+		[[nodiscard]] static constexpr auto get_key(const bucket_type& vt) -> const key_type& {
+			if constexpr(is_map_v<value>) {
+				return vt.first;
+			}
+			else {
+				return vt;
+			}
+		}
+
+		[[nodiscard]] static constexpr auto get_bucket(u64 h) -> u64 {
+			return (h >> 32) & bucket_mask;
+		}
+		[[nodiscard]] static constexpr auto get_slot(u64 h, u32 pilot) -> u64 {
+			return compute_hash(h ^ pilot) & slot_mask;
+		}
+
+		template<typename K>
+		[[nodiscard]] constexpr auto do_find(const K& k) const -> const_iterator {
+			const u64 h = static_cast<u64>(m_hash(k));
+			const u32 index = m_slots[get_slot(h, m_pilots[get_bucket(h)])];
+
+			// free slots refer to entry 0, which lives in another slot and therefore never compares equal
+			if(m_equal(k, get_key(m_entries[index]))) {
+				return m_entries + index;
+			}
+
+			// keys of a failed build don't necessarily have a slot, misses fall back to comparing every entry
+			return m_failed ? find_linear(k) : end();
+		}
+
+		template<typename K>
+		[[nodiscard]] constexpr auto find_linear(const K& k) const -> const_iterator {
+			for(u64 i = 0; i < count; ++i) {
+				if(m_equal(k, get_key(m_entries[i]))) {
+					return m_entries + i;
+				}
+			}
+
+			return end();
+		}
+
+		// errors are compile errors for constexpr instances and assertions in debug builds, a release build
+		// marks the map as failed, which keeps lookups correct (but linear for keys without a slot)
+		constexpr void build() {
+			u64 hashes[count] = {};
+			u32 bucket_starts[bucket_count + 1] = {};
+			u32 order[count] = {};   // entry indices sorted by bucket
+			u64 slots[count] = {};   // slots of the bucket which is being placed
+			bool taken[slot_count] = {};
+
+			for(u64 i = 0; i < count; ++i) {
+				hashes[i] = static_cast<u64>(m_hash(get_key(m_entries[i])));
+				++bucket_starts[get_bucket(hashes[i]) + 1];
+			}
+
+			u32 max_bucket_size = 0;
+
+			for(u64 b = 0; b < bucket_count; ++b) {
+				max_bucket_size = max(max_bucket_size, bucket_starts[b + 1]);
+				bucket_starts[b + 1] += bucket_starts[b];
+			}
+
+			u32 bucket_fill[bucket_count] = {};
+
+			for(u64 i = 0; i < count; ++i) {
+				const u64 b = get_bucket(hashes[i]);
+				order[bucket_starts[b] + bucket_fill[b]++] = static_cast<u32>(i);
+			}
+
+			// keys which share their full hash can never be separated
+			for(u64 b = 0; b < bucket_count; ++b) {
+				for(u32 i = bucket_starts[b]; i < bucket_starts[b + 1]; ++i) {
+					for(u32 j = bucket_starts[b]; j < i; ++j) {
+						if(hashes[order[i]] == hashes[order[j]]) {
+							detail::static_map_error("static map contains duplicate keys (or keys with colliding hashes)");
+							m_failed = true;
+							return;
+						}
+					}
+				}
+			}
+
+			// place large buckets first, while most slots are still free
+			for(u32 size = max_bucket_size; size > 0; --size) {
+				for(u64 b = 0; b < bucket_count; ++b) {
+					if(bucket_starts[b + 1] - bucket_starts[b] != size) {
+						continue;
+					}
+
+					const u32 first = bucket_starts[b];
+
+					for(u32 pilot = 0;; ++pilot) {
+						if(pilot == max_pilot) {
+							detail::static_map_error("static map found no pilot which places the keys of a bucket, the hash is too weak");
+							m_failed = true;
+							return;
+						}
+
+						bool valid = true;
+
+						for(u32 i = 0; i < size && valid; ++i) {
+							slots[i] = get_slot(hashes[order[first + i]], pilot);
+							valid = !taken[slots[i]];
+
+							for(u32 j = 0; j < i && valid; ++j) {
+								valid = slots[i] != slots[j];
+							}
+						}
+
+						if(valid) {
+							for(u32 i = 0; i < size; ++i) {
+								taken[slots[i]] = true;
+								m_slots[slots[i]] = order[first + i];
+							}
+
+							m_pilots[b] = pilot;
+							break;
+						}
+					}
+				}
+			}
+		}
+	protected:
+		bucket_type m_entries[count];
+		u32 m_pilots[bucket_count] = {};
+		u32 m_slots[slot_count] = {}; // entry index of every slot
+		bool m_failed = false;        // the build didn't place every key, see build()
+
+		[[no_unique_address]] hash m_hash;
+		[[no_unique_address]] key_equal m_equal;
+	};
+
+	template<
+		typename key,
+		u64 count,
+		typename hash = hash<key>,
+		typename key_equal = std::equal_to<>
+	>
+	using static_set = static_map<key, void, count, hash, key_equal>;
+} // namespace utility
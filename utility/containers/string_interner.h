@@ -1,12 +1,35 @@
 #pragma once
 #include "utility/allocators/block_allocator.h"
+#include "utility/allocators/virtual_allocator.h"
 #include "utility/containers/dynamic_string.h"
 #include "utility/containers/map.h"
 
 namespace utility {
-	class string_interner {
+	namespace detail {
+		// a block allocator allocates its blocks one at a time, a virtual allocator can never grow past the
+		// range it reserved up front, reserving address space doesn't commit any memory though
+		template<typename arena>
+		inline constexpr u64 default_arena_size = 1024;
+
+		template<>
+		inline constexpr u64 default_arena_size<virtual_allocator> = u64(4) << 30;
+	} // namespace detail
+
+	/**
+	 * \brief Deduplicating string storage.
+	 * \tparam arena Allocator used for the string storage, has to provide the safepoint interface of
+	 * the block allocator
+	 */
+	template<typename arena>
+	class string_interner_base {
 	public:
-		string_interner() : m_allocator(1024) {}
+		using allocator_type = arena;
+
+		/**
+		 * \param arena_size Block size of a block allocator (1KB by default), reserve size of a virtual
+		 * allocator (4GB of address space by default)
+		 */
+		string_interner_base(u64 arena_size = detail::default_arena_size<arena>) : m_allocator(arena_size) {}
 
 		auto add(const dynamic_string& string) -> string_view* {
 			// since the allocation in a block allocator is effectively an increment we can afford to 
@@ -16,7 +39,7 @@ namespace utility {
 			char* memory = static_cast<char*>(m_allocator.allocate(string.get_size() + 1));
 			memcpy(memory, string.get_data(), string.get_size() + 1);
 
-			string_view* view = m_allocator.emplace<string_view>(memory, string.get_size());
+			string_view* view = m_allocator.template emplace<string_view>(memory, string.get_size());
 			auto result = m_strings.insert({ *view, view });
 	
 			if(result.second == false) {
@@ -38,6 +61,18 @@ namespace utility {
 			m_strings.clear();
 		}
 
+		/**
+		 * \brief Returns the number of bytes allocated by the interner (string storage and lookup map).
+		 */
+		[[nodiscard]] auto get_memory_usage() const -> u64 {
+			if constexpr(requires { m_allocator.get_committed_bytes(); }) {
+				return m_allocator.get_committed_bytes() + m_strings.get_memory_usage();
+			}
+			else {
+				return m_allocator.get_reserved_bytes() + m_strings.get_memory_usage();
+			}
+		}
+
 		void print() {
 			for(const auto& [key, value] : m_strings) {
 				console::print("{}\n", key);
@@ -45,7 +80,10 @@ namespace utility {
 		}
 	private:
 		map<string_view, string_view*> m_strings;
-		block_allocator m_allocator;
+		allocator_type m_allocator;
 	};
+
+	using string_interner = string_interner_base<block_allocator>;
+	using virtual_string_interner = string_interner_base<virtual_allocator>;
 } // namespace utility 
 
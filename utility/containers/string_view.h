@@ -33,11 +33,11 @@ namespace utility {
 		[[nodiscard]] auto begin() const -> const_iterator { return m_data; }
 		[[nodiscard]] auto end() const -> const_iterator { return m_data + m_size; }
 
-		[[nodiscard]] auto get_data() const -> element_type* {
+		[[nodiscard]] constexpr auto get_data() const -> element_type* {
 			return m_data;
 		}
 
-		[[nodiscard]] auto get_size() const -> size_type {
+		[[nodiscard]] constexpr auto get_size() const -> size_type {
 			return m_size;
 		}
 
@@ -70,13 +70,13 @@ namespace utility {
 
 			return true;
 		}
-		[[nodiscard]] auto operator==(const string_view_base& other) const -> bool {
+		[[nodiscard]] constexpr auto operator==(const string_view_base& other) const -> bool {
 			if(other.get_size() != m_size) {
 				return false;
 			}
 
 			for(size_type i = 0; i < m_size; ++i) {
-				if(other[i] != m_data[i]) {
+				if(other.m_data[i] != m_data[i]) {
 					return false;
 				}
 			}
@@ -97,8 +97,8 @@ namespace utility {
 
 	template<typename d, typename s>
 	struct hash<string_view_base<d, s>> {
-		auto operator()(const string_view_base<d, s>& obj) const noexcept -> u64 {
-			return compute_hash(obj.get_data(), sizeof(char) * obj.get_size());
+		constexpr auto operator()(const string_view_base<d, s>& obj) const noexcept -> u64 {
+			return compute_hash(obj.get_data(), sizeof(d) * obj.get_size());
 		}
 	};
 
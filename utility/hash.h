@@ -2,15 +2,21 @@
 #include "utility/types.h"
 
 namespace utility {
-	inline void mum(u64* a, u64* b) {
+	// the hashing functions are constexpr, this way hashes can be precomputed at compile time (see static_map)
+	constexpr void mum(u64* a, u64* b) {
 #if defined(__SIZEOF_INT128__)
 		__uint128_t r = *a;
 		r *= *b;
 		*a = static_cast<u64>(r);
 		*b = static_cast<u64>(r >> 64U);
-#elif defined(_MSC_VER) && defined(_M_X64)
-		*a = _umul128(*a, *b, b);
 #else
+#if defined(_MSC_VER) && defined(_M_X64)
+		if(!std::is_constant_evaluated()) {
+			*a = _umul128(*a, *b, b);
+			return;
+		}
+#endif
+
 		u64 ha = *a >> 32U;
 		u64 hb = *b >> 32U;
 		u64 la = static_cast<u32>(*a);
@@ -31,40 +37,73 @@ namespace utility {
 #endif
 	}
 
-	[[nodiscard]] inline auto mix(u64 a, u64 b) -> u64 {
+	[[nodiscard]] constexpr auto mix(u64 a, u64 b) -> u64 {
 		mum(&a, &b);
 		return a ^ b;
 	}
 
-	[[nodiscard]] inline auto compute_hash(u64 x) -> u64 {
+	[[nodiscard]] constexpr auto compute_hash(u64 x) -> u64 {
 		return mix(x, UINT64_C(0x9E3779B97F4A7C15));
 	}
 
-	[[nodiscard]] inline auto r4(const u8* p) -> u64 {
-		u32 v{};
-		utility::memcpy(&v, p, 4);
-		return v;
-	}
+	namespace detail {
+		// memcpy isn't usable in constant expressions, assemble the (little-endian) value byte by byte there
+		template<u64 size, typename byte_type>
+		[[nodiscard]] constexpr auto read_bytes(const byte_type* p) -> u64 {
+			if(std::is_constant_evaluated()) {
+				u64 v = 0;
 
-	[[nodiscard]] inline auto r8(const u8* p) -> u64 {
-		u64 v{};
-		utility::memcpy(&v, p, 8U);
-		return v;
-	}
+				for(u64 i = 0; i < size; ++i) {
+					v |= static_cast<u64>(static_cast<u8>(p[i])) << (i * 8U);
+				}
 
-	[[nodiscard]] inline auto r3(const u8* p, u64 k) -> u64 {
-		return (static_cast<u64>(p[0]) << 16U) | (static_cast<u64>(p[k >> 1U]) << 8U) | p[k - 1];
-	}
+				return v;
+			}
 
-	[[maybe_unused]] [[nodiscard]] inline auto compute_hash(void const* key, u64 len) -> u64 {
-		static constexpr u64 secret[] = { 
+			if constexpr(size == 4) {
+				u32 v{};
+				utility::memcpy(&v, p, 4);
+				return v;
+			}
+			else {
+				u64 v{};
+				utility::memcpy(&v, p, 8U);
+				return v;
+			}
+		}
+
+		static constexpr u64 hash_secret[] = {
 			UINT64_C(0xa0761d6478bd642f),
 			UINT64_C(0xe7037ed1a0b428db),
 			UINT64_C(0x8ebc6af09c88c6e3),
 			UINT64_C(0x589965cc75374cc3)
 		};
+	} // namespace detail
 
-		auto const* p = static_cast<u8 const*>(key);
+	template<typename byte_type>
+	[[nodiscard]] constexpr auto r4(const byte_type* p) -> u64 {
+		return detail::read_bytes<4>(p);
+	}
+
+	template<typename byte_type>
+	[[nodiscard]] constexpr auto r8(const byte_type* p) -> u64 {
+		return detail::read_bytes<8>(p);
+	}
+
+	template<typename byte_type>
+	[[nodiscard]] constexpr auto r3(const byte_type* p, u64 k) -> u64 {
+		return (static_cast<u64>(static_cast<u8>(p[0])) << 16U) | (static_cast<u64>(static_cast<u8>(p[k >> 1U])) << 8U) | static_cast<u8>(p[k - 1]);
+	}
+
+	/**
+	 * \brief Hashes \b len bytes starting at \b key, usable in constant expressions for byte-sized types.
+	 */
+	template<typename byte_type>
+		requires (sizeof(byte_type) == 1)
+	[[nodiscard]] constexpr auto compute_hash(const byte_type* key, u64 len) -> u64 {
+		const auto& secret = detail::hash_secret;
+
+		const byte_type* p = key;
 		u64 seed = secret[0];
 		u64 a;
 		u64 b;
@@ -114,6 +153,10 @@ namespace utility {
 		return mix(secret[1] ^ len, mix(a ^ secret[1], b ^ seed));
 	}
 
+	[[maybe_unused]] [[nodiscard]] inline auto compute_hash(void const* key, u64 len) -> u64 {
+		return compute_hash(static_cast<u8 const*>(key), len);
+	}
+
 	/**
 	 * \brief Base hash operator.
 	 * \tparam type Type to hash
@@ -121,12 +164,12 @@ namespace utility {
 	template<typename type>
 	struct hash {};
 
-#define DETAIL_CREATE_HASH_OPERATOR(type)                    \
-	template<>                                                 \
-	struct hash<type> {                                        \
-		auto operator()(const type& obj) const noexcept -> u64 { \
-			return compute_hash(static_cast<u64>(obj));            \
-		}                                                        \
+#define DETAIL_CREATE_HASH_OPERATOR(type)                              \
+	template<>                                                           \
+	struct hash<type> {                                                  \
+		constexpr auto operator()(const type& obj) const noexcept -> u64 { \
+			return compute_hash(static_cast<u64>(obj));                      \
+		}                                                                  \
 	}
 
 	DETAIL_CREATE_HASH_OPERATOR(i8);
@@ -19,6 +19,25 @@ namespace utility {
 		}
 	}
 
+	/**
+	 * \brief Moves \b count elements from \b source into the uninitialized memory at \b destination and
+	 * destroys the originals. Trivially relocatable types are copied with a single memcpy.
+	 */
+	template<typename type, typename size_type>
+	void relocate_range(type* destination, type* source, size_type count) {
+		if constexpr(is_trivially_relocatable_v<type>) {
+			if(count > 0) {
+				utility::memcpy(destination, source, count * sizeof(type));
+			}
+		}
+		else {
+			for(size_type i = 0; i < count; ++i) {
+				utility::construct_at(destination + i, utility::move(source[i]));
+				utility::destroy_at(source + i);
+			}
+		}
+	}
+
 	template<typename iterator_type>
 	auto distance(iterator_type begin, iterator_type end) -> u64 {
 		u64 diff = 0;
@@ -21,7 +21,7 @@ namespace utility {
 	template<typename type>
 	class result {
 	public:
-		result(type value) : m_value(move(value)) {}
+		result(type value) : m_value(utility::move(value)) {}
 		result(const error& err) : m_error(err) {}
 
 		[[nodiscard]] auto has_value() const -> bool {
@@ -37,7 +37,7 @@ namespace utility {
 		}
 
 		[[nodiscard]] auto get_value() -> type {
-			return move(m_value);
+			return utility::move(m_value);
 		}
 
 		[[nodiscard]] auto get_error() const -> const error& {
@@ -121,6 +121,9 @@ namespace utility {
 		base_type m_data;
 	};
 
+	template<>
+	struct is_trivially_relocatable<filepath> : is_trivially_relocatable<filepath::base_type> {};
+
 	template<typename stream_type>
 	struct stream_writer<filepath, stream_type> {
 		static void write(const filepath& value, stream_type& str) {
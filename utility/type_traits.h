@@ -54,6 +54,17 @@ namespace utility {
   using true_type =  __bool_constant<true>;
   using false_type = __bool_constant<false>;
 
+	/**
+	 * \brief Marks types which can be moved to a different address with a plain memcpy, the source is then
+	 * treated as if it was destroyed. Containers which only refer to their storage through pointers can
+	 * opt in by specializing this trait.
+	 */
+	template<typename type>
+	struct is_trivially_relocatable : __bool_constant<is_trivial_v<type>> {};
+
+	template<typename type>
+	inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<type>::value;
+
   template<typename type>
   struct is_void : public false_type { };
 
@@ -2,12 +2,14 @@
 #ifdef _WIN32
 #define NOMINMAX
 #include <windows.h>
+#include <xmmintrin.h>
 #elif __linux__
 #include <sys/stat.h>
 #include <unistd.h>
 #endif
 
 #include <stdio.h>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
@@ -46,12 +48,75 @@ namespace utility {
 	template<typename type>
 	using initializer_list = std::initializer_list<type>;
 
+#ifdef UTILITY_SLAB_ALLOCATOR
+	namespace detail {
+		// implemented in utility/allocators/slab_allocator.h
+		[[nodiscard]] inline auto slab_malloc(u64 size) -> void*;
+		inline void slab_free(void* data);
+		[[nodiscard]] inline auto slab_try_expand(void* data, u64 new_size) -> bool;
+	} // namespace detail
+#endif
+
+#ifdef UTILITY_MEMORY_TRACKING
+	namespace detail {
+		// implemented in utility/allocators/memory_tracker.h
+		static constexpr u64 tracking_header_size = 16;
+
+		[[nodiscard]] inline auto track_allocation(void* data, u64 size) -> void*;
+		[[nodiscard]] inline auto track_deallocation(void* data) -> void*;
+		[[nodiscard]] inline auto track_expansion(void* data, u64 new_size) -> bool;
+	} // namespace detail
+#endif
+
+	namespace detail {
+		// backing allocation functions, without any instrumentation
+		inline void raw_free(void* data) {
+#ifdef UTILITY_SLAB_ALLOCATOR
+			slab_free(data);
+#else
+			std::free(data);
+#endif
+		}
+		[[nodiscard]] inline auto raw_malloc(u64 size) -> void* {
+#ifdef UTILITY_SLAB_ALLOCATOR
+			return slab_malloc(size);
+#else
+			return std::malloc(size);
+#endif
+		}
+		[[nodiscard]] inline auto raw_try_expand(void* data, u64 new_size) -> bool {
+#ifdef UTILITY_SLAB_ALLOCATOR
+			return slab_try_expand(data, new_size);
+#else
+			(void)data;
+			(void)new_size;
+			return false;
+#endif
+		}
+	} // namespace detail
+
 	// memory
 	inline void free(void* data) {
-		std::free(data);
+#ifdef UTILITY_MEMORY_TRACKING
+		detail::raw_free(detail::track_deallocation(data));
+#else
+		detail::raw_free(data);
+#endif
 	}
 	[[nodiscard]] inline auto malloc(u64 size) -> void* {
-		return std::malloc(size);
+#ifdef UTILITY_MEMORY_TRACKING
+		return detail::track_allocation(detail::raw_malloc(size + detail::tracking_header_size), size);
+#else
+		return detail::raw_malloc(size);
+#endif
+	}
+	// attempts to grow an allocation returned by utility::malloc in place, only supported by the slab allocator
+	[[nodiscard]] inline auto try_expand(void* data, u64 new_size) -> bool {
+#ifdef UTILITY_MEMORY_TRACKING
+		return detail::track_expansion(data, new_size);
+#else
+		return detail::raw_try_expand(data, new_size);
+#endif
 	}
 	inline void memcpy(void* destination, const void* source, u64 size) {
 		std::memcpy(destination, source, size);
@@ -62,13 +127,31 @@ namespace utility {
 	inline void memmove(void* destination, const void* source, u64 size) {
 		std::memmove(destination, source, size);
 	}
+	// hints the cpu to start loading the cache line which contains address
+	inline void prefetch(const void* address) {
+#ifdef _MSC_VER
+		_mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+		__builtin_prefetch(address);
+#endif
+	}
 	[[nodiscard]] inline auto align(u64 value, u64 alignment) -> u64 {
 		return value + (alignment - (value % alignment)) % alignment;
 	}
 	// strings
 	static constexpr char g_eof = -1;
 
-	[[nodiscard]] inline auto string_len(const char* str) -> u64 {
+	[[nodiscard]] constexpr auto string_len(const char* str) -> u64 {
+		if(std::is_constant_evaluated()) {
+			u64 len = 0;
+
+			while(str[len] != '\0') {
+				++len;
+			}
+
+			return len;
+		}
+
 		return std::strlen(str);
 	}
 	[[nodiscard]] inline auto string_len(const wchar_t* str) -> u64 {
@@ -105,12 +188,12 @@ namespace utility {
 	}
 
 	template<typename a, typename b = a>
-	[[nodiscard]] auto min(a left, b right) {
+	[[nodiscard]] constexpr auto min(a left, b right) {
 		return left > right ? right : left;
 	}
 
 	template<typename a, typename b = a>
-	[[nodiscard]] auto max(a left, b right) {
+	[[nodiscard]] constexpr auto max(a left, b right) {
 		return left > right ? left : right;
 	}
 
@@ -245,3 +328,13 @@ namespace utility {
 #define CONCATENATE(__x, __y) CONCATENATE_INDIRECT(__x, __y)
 
 #define SUPPRESS_C4100(__value) (void)__value
+
+// route utility::malloc/utility::free through the size-class slab allocator
+#ifdef UTILITY_SLAB_ALLOCATOR
+#include "utility/allocators/slab_allocator.h"
+#endif
+
+// record every utility::malloc/utility::free call
+#ifdef UTILITY_MEMORY_TRACKING
+#include "utility/allocators/memory_tracker.h"
+#endif